@@ -0,0 +1,102 @@
+import argparse
+import csv
+import json
+import os
+import sys
+
+from srpt_oracle import schedule_files
+
+
+description = """Builds a competition CSV (with Submission, Schedule and Average columns, as read by score_competition.py)
+from the summaries the simulator writes with --summary, in one pass over the summaries. The summaries of each
+submission are read from SUMMARIES/SUBMISSION/SCHEDULE, and a schedule without a summary (or that the simulation
+failed to complete) has an average of NULL. If the simulations were run with run_limited, the resources they used
+(e.g., user_time_us and max_rss_kb) can be added as columns too.
+"""
+
+epilog = """Example:
+  python3 {} output/.summary/custom schedules > competition.csv
+  python3 {} -f p99_turnaround_time -f user_time_us -f max_rss_kb output/.summary/custom schedules alice bob
+"""
+
+
+def read_json(path):
+    """Reads the JSON object in the given file, returning None if it is missing or invalid"""
+    try:
+        with open(path) as file:
+            value = json.load(file)
+    except (OSError, ValueError):
+        return None
+    return value if isinstance(value, dict) else None
+
+
+def read_summary(path, resources_path=None):
+    """
+    Reads the summary at the given path, returning its statistics, or None if it is missing or incomplete. The
+    resources the simulator used (written by run_limited) are added from resources_path, if given.
+    """
+    summary = read_json(path)
+    if not summary or not summary.get('completed'):
+        return None
+    if resources_path:
+        summary.update(read_json(resources_path) or {})
+    return summary
+
+
+def format_field(value):
+    """Formats a statistic from a summary for the CSV (as NULL if it is missing)"""
+    if value is None:
+        return 'NULL'
+    return f'{value:.2f}' if isinstance(value, float) else str(value)
+
+
+def submission_summaries(directory):
+    """Finds the summaries of a submission, returning a dictionary from schedule name to path"""
+    try:
+        with os.scandir(directory) as entries:
+            return {entry.name: entry.path for entry in entries if entry.is_file()}
+    except OSError:
+        return {}
+
+
+def main(args):
+    """Writes the competition CSV described by the command line arguments"""
+    schedules = [os.path.basename(schedule) for schedule in schedule_files([args.schedules])]
+    submissions = args.submission
+    if not submissions:
+        try:
+            submissions = sorted(entry.name for entry in os.scandir(args.summaries)
+                                 if entry.is_dir() and not entry.name.startswith('.'))
+        except OSError:
+            print(f'Unable to read {args.summaries}', file=sys.stderr)
+            return 1
+
+    output = open(args.output, 'w', newline='') if args.output else sys.stdout
+    writer = csv.writer(output, lineterminator='\n')
+    writer.writerow(['Submission', 'Schedule', 'Average'] + args.field)
+    for submission in submissions:
+        summaries = submission_summaries(os.path.join(args.summaries, submission))
+        for schedule in schedules:
+            summary = read_summary(summaries[schedule], summaries.get(schedule + '.resources')) \
+                if schedule in summaries else None
+            fields = ['average_turnaround_time'] + args.field
+            writer.writerow([submission, schedule] +
+                            [format_field(summary.get(field) if summary else None) for field in fields])
+    if args.output:
+        output.close()
+    return 0
+
+
+if __name__ == "__main__":
+    # Process arguments
+    parser = argparse.ArgumentParser(description=description, epilog=epilog.format(sys.argv[0], sys.argv[0]),
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-f', '--field', action='append', default=[],
+                        help='another statistic from the summaries to add as a column, e.g. p99_turnaround_time (may '
+                             'be given more than once)')
+    parser.add_argument('-o', '--output', help='the file to write the CSV to (defaults to standard output)')
+    parser.add_argument('summaries', help='the directory containing a directory of summaries for each submission')
+    parser.add_argument('schedules', help='the directory of schedules that were simulated')
+    parser.add_argument('submission', nargs='*',
+                        help='the submissions to include, in order (defaults to every directory in summaries)')
+    sys.exit(main(parser.parse_args()))
@@ -0,0 +1,451 @@
+/*
+ * An implementation of a Completely Fair Scheduler (CFS) style algorithm.
+ * Runnable processes are kept in a red-black tree ordered by virtual runtime
+ * (ties broken by the lowest PID), with the leftmost node cached so the next
+ * process to run is found in O(1) and inserted/removed in O(log n).
+ * Every process has the same weight, so a process's virtual runtime is the
+ * processing time it has received since it was placed in the tree.
+ * Time slices are computed from a target latency and a minimum granularity,
+ * in the same way as the Linux scheduler.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The period (in time units) in which every runnable process should run once */
+#define TARGET_LATENCY 12
+
+/* The smallest time slice a process will be given, however many processes are runnable */
+#define MIN_GRANULARITY 3
+
+/* How far ahead of a newly arrived process the running process must be before it is preempted */
+#define WAKEUP_GRANULARITY 2
+
+/* The process details we're interested in for the CFS algorithm.*/
+typedef struct cfs_process {
+  unsigned int pid;
+  unsigned int processing_time;
+  unsigned int arrival_time;
+  unsigned int processed_time;
+  unsigned long vruntime;  // the virtual runtime, which orders the tree
+  unsigned int slice_used;  // time used since the process was last picked
+  bool red;  // the colour of the node in the red-black tree
+  struct cfs_process *left;
+  struct cfs_process *right;
+  struct cfs_process *parent;
+} cfs_process;
+
+/* The root of the tree of runnable processes (not including the running process) */
+cfs_process *root = NULL;
+
+/* The runnable process with the smallest virtual runtime (the leftmost node of the tree) */
+cfs_process *leftmost = NULL;
+
+/* The process currently running (kept out of the tree while it runs) */
+cfs_process *current = NULL;
+
+/* The number of processes in the tree */
+unsigned int nr_queued = 0;
+
+/* A monotonically increasing lower bound on the virtual runtime of every runnable process */
+unsigned long min_vruntime = 0;
+
+/*
+ * Determines whether process a should be to the left of process b in the tree.
+ * parameters:
+ *   a - the first process to compare
+ *   b - the second process to compare
+ * returns:
+ *   TRUE if a has a smaller virtual runtime than b, or the same virtual runtime and a lower PID
+ */
+bool vruntime_before(const cfs_process *a, const cfs_process *b) {
+  return a->vruntime < b->vruntime || (a->vruntime == b->vruntime && a->pid < b->pid);
+}
+
+/*
+ * Determines whether the given node is red (leaves, which are NULL, are black).
+ * parameters:
+ *   node - the node to check
+ * returns:
+ *   TRUE if the node is red, FALSE otherwise
+ */
+bool is_red(const cfs_process *node) {
+  return node && node->red;
+}
+
+/*
+ * Replaces old_child with new_child as the child of parent (or the root if parent is NULL).
+ * parameters:
+ *   parent - the parent of old_child
+ *   old_child - the node being replaced
+ *   new_child - the node replacing it (may be NULL)
+ */
+void replace_child(cfs_process *parent, cfs_process *old_child, cfs_process *new_child) {
+  if (!parent) {
+    root = new_child;
+  } else if (parent->left == old_child) {
+    parent->left = new_child;
+  } else {
+    parent->right = new_child;
+  }
+  if (new_child) {
+    new_child->parent = parent;
+  }
+}
+
+/*
+ * Rotates the tree left around the given node, so its right child takes its place.
+ * parameters:
+ *   node - the node to rotate around
+ */
+void rotate_left(cfs_process *node) {
+  cfs_process *pivot = node->right;
+  node->right = pivot->left;
+  if (pivot->left) {
+    pivot->left->parent = node;
+  }
+  replace_child(node->parent, node, pivot);
+  pivot->left = node;
+  node->parent = pivot;
+}
+
+/*
+ * Rotates the tree right around the given node, so its left child takes its place.
+ * parameters:
+ *   node - the node to rotate around
+ */
+void rotate_right(cfs_process *node) {
+  cfs_process *pivot = node->left;
+  node->left = pivot->right;
+  if (pivot->right) {
+    pivot->right->parent = node;
+  }
+  replace_child(node->parent, node, pivot);
+  pivot->right = node;
+  node->parent = pivot;
+}
+
+/*
+ * Inserts the given process in to the tree by virtual runtime, updating the cached leftmost node.
+ * parameters:
+ *   process - the process to insert
+ */
+void tree_insert(cfs_process *process) {
+  cfs_process *parent = NULL;
+  cfs_process **link = &root;
+  bool is_leftmost = TRUE;
+
+  // Find where the process belongs, noting whether it only ever went left
+  while (*link) {
+    parent = *link;
+    if (vruntime_before(process, parent)) {
+      link = &parent->left;
+    } else {
+      link = &parent->right;
+      is_leftmost = FALSE;
+    }
+  }
+  process->parent = parent;
+  process->left = NULL;
+  process->right = NULL;
+  process->red = TRUE;
+  *link = process;
+  if (is_leftmost) {
+    leftmost = process;
+  }
+  nr_queued++;
+
+  // Restore the red-black properties
+  cfs_process *node = process;
+  while (is_red(node->parent)) {
+    cfs_process *node_parent = node->parent;
+    cfs_process *grandparent = node_parent->parent;
+    if (node_parent == grandparent->left) {
+      cfs_process *uncle = grandparent->right;
+      if (is_red(uncle)) {
+        node_parent->red = FALSE;
+        uncle->red = FALSE;
+        grandparent->red = TRUE;
+        node = grandparent;
+        continue;
+      }
+      if (node == node_parent->right) {
+        rotate_left(node_parent);
+        node = node_parent;
+        node_parent = node->parent;
+      }
+      node_parent->red = FALSE;
+      grandparent->red = TRUE;
+      rotate_right(grandparent);
+    } else {
+      cfs_process *uncle = grandparent->left;
+      if (is_red(uncle)) {
+        node_parent->red = FALSE;
+        uncle->red = FALSE;
+        grandparent->red = TRUE;
+        node = grandparent;
+        continue;
+      }
+      if (node == node_parent->left) {
+        rotate_right(node_parent);
+        node = node_parent;
+        node_parent = node->parent;
+      }
+      node_parent->red = FALSE;
+      grandparent->red = TRUE;
+      rotate_left(grandparent);
+    }
+  }
+  root->red = FALSE;
+}
+
+/*
+ * Removes the given process from the tree, updating the cached leftmost node.
+ * parameters:
+ *   process - the process to remove (which must be in the tree)
+ */
+void tree_erase(cfs_process *process) {
+  // The successor is the new leftmost node if the leftmost node is being removed
+  if (process == leftmost) {
+    cfs_process *successor = process->right;
+    if (successor) {
+      while (successor->left) {
+        successor = successor->left;
+      }
+    } else {
+      successor = process->parent;
+    }
+    leftmost = successor;
+  }
+
+  // Remove the node, tracking the child that takes the removed colour's place (and its parent)
+  cfs_process *child;
+  cfs_process *child_parent;
+  bool removed_red;
+  if (!process->left || !process->right) {
+    child = process->left ? process->left : process->right;
+    child_parent = process->parent;
+    removed_red = process->red;
+    replace_child(process->parent, process, child);
+  } else {
+    // Two children: splice out the in-order successor and put it in the process's place
+    cfs_process *successor = process->right;
+    while (successor->left) {
+      successor = successor->left;
+    }
+    removed_red = successor->red;
+    child = successor->right;
+    if (successor->parent == process) {
+      child_parent = successor;
+    } else {
+      child_parent = successor->parent;
+      replace_child(successor->parent, successor, child);
+      successor->right = process->right;
+      successor->right->parent = successor;
+    }
+    replace_child(process->parent, process, successor);
+    successor->left = process->left;
+    successor->left->parent = successor;
+    successor->red = process->red;
+  }
+  nr_queued--;
+
+  if (removed_red) {
+    return;
+  }
+
+  // Removing a black node leaves one path short of a black node, so restore the red-black properties
+  while (child != root && !is_red(child)) {
+    if (child == child_parent->left) {
+      cfs_process *sibling = child_parent->right;
+      if (is_red(sibling)) {
+        sibling->red = FALSE;
+        child_parent->red = TRUE;
+        rotate_left(child_parent);
+        sibling = child_parent->right;
+      }
+      if (!is_red(sibling->left) && !is_red(sibling->right)) {
+        sibling->red = TRUE;
+        child = child_parent;
+        child_parent = child->parent;
+        continue;
+      }
+      if (!is_red(sibling->right)) {
+        sibling->left->red = FALSE;
+        sibling->red = TRUE;
+        rotate_right(sibling);
+        sibling = child_parent->right;
+      }
+      sibling->red = child_parent->red;
+      child_parent->red = FALSE;
+      sibling->right->red = FALSE;
+      rotate_left(child_parent);
+    } else {
+      cfs_process *sibling = child_parent->left;
+      if (is_red(sibling)) {
+        sibling->red = FALSE;
+        child_parent->red = TRUE;
+        rotate_right(child_parent);
+        sibling = child_parent->left;
+      }
+      if (!is_red(sibling->left) && !is_red(sibling->right)) {
+        sibling->red = TRUE;
+        child = child_parent;
+        child_parent = child->parent;
+        continue;
+      }
+      if (!is_red(sibling->left)) {
+        sibling->right->red = FALSE;
+        sibling->red = TRUE;
+        rotate_left(sibling);
+        sibling = child_parent->left;
+      }
+      sibling->red = child_parent->red;
+      child_parent->red = FALSE;
+      sibling->left->red = FALSE;
+      rotate_right(child_parent);
+    }
+    child = root;
+  }
+  if (child) {
+    child->red = FALSE;
+  }
+}
+
+/*
+ * Prints out the runnable processes in virtual runtime order.
+ * parameters:
+ *   node: The root of the subtree to print
+ */
+void print_tree(cfs_process *node) {
+  if (!node) {
+    return;
+  }
+  print_tree(node->left);
+  printf("\tpid: %d, processing_time %d, arrival_time: %d, processed_time: %d, vruntime: %lu\n",
+      node->pid,
+      node->processing_time,
+      node->arrival_time,
+      node->processed_time,
+      node->vruntime);
+  print_tree(node->right);
+}
+
+/*
+ * Prints out the running process and the tree of runnable processes.
+ */
+void print_runqueue() {
+  if (current) {
+    printf("Current process: pid %d, vruntime: %lu, slice_used: %d\n", current->pid, current->vruntime, current->slice_used);
+  }
+  printf("Runnable processes (min_vruntime: %lu):\n", min_vruntime);
+  print_tree(root);
+}
+
+/*
+ * Advances min_vruntime to the smallest virtual runtime of any runnable process, if that is larger.
+ */
+void update_min_vruntime() {
+  unsigned long vruntime = min_vruntime;
+  if (current) {
+    vruntime = current->vruntime;
+  }
+  if (leftmost && (!current || leftmost->vruntime < vruntime)) {
+    vruntime = leftmost->vruntime;
+  }
+  if (vruntime > min_vruntime) {
+    min_vruntime = vruntime;
+  }
+}
+
+/*
+ * Determines the time slice for the running process.
+ * The target latency is shared between all runnable processes, but no process gets less
+ * than the minimum granularity.
+ * returns:
+ *   The number of time units the running process may run before it is preempted
+ */
+unsigned int time_slice() {
+  unsigned int nr_running = nr_queued + (current ? 1 : 0);
+  unsigned int slice = TARGET_LATENCY / nr_running;
+  return slice < MIN_GRANULARITY ? MIN_GRANULARITY : slice;
+}
+
+/*
+ * Adds the given process to the ready queue, indicating it is ready to be scheduled.
+ * The process is placed in the tree at the current min_vruntime, so it neither jumps ahead of
+ * nor falls behind the processes already runnable.
+ * parameters:
+ *   process - the process to add to the ready queue
+ */
+void add_to_ready_queue(const process_initial process) {
+  // Construct the new cfs_process
+  cfs_process *new_process = malloc(sizeof(cfs_process));
+  if (!new_process) {
+    perror("Failed to allocate memory for new process");
+    exit(1);
+  }
+  new_process->pid = process.pid;
+  new_process->processing_time = process.processing_time;
+  new_process->arrival_time = process.arrival_time;
+  new_process->processed_time = 0;
+  new_process->vruntime = min_vruntime;
+  new_process->slice_used = 0;
+
+  tree_insert(new_process);
+
+  // If in debug mode, print out the run queue after it has changed
+  if (debug) {
+    printf("Run queue after adding process with pid %d:\n", process.pid);
+    print_runqueue();
+  }
+}
+
+/*
+ * Determines the next process to the scheduled.
+ * Implements CFS, meaning the running process continues until it has used its time slice
+ * (or a newly arrived process is far enough behind it), at which point it is returned to the
+ * tree and the process with the smallest virtual runtime is run.
+ * returns:
+ *   The PID of the process to be scheduled next, or 0 if no process should be scheduled
+ */
+unsigned int get_next_scheduled_process() {
+  // Preempt the running process if it has used its slice or a waiting process is far enough behind
+  if (current && leftmost &&
+      (current->slice_used >= time_slice() || leftmost->vruntime + WAKEUP_GRANULARITY < current->vruntime)) {
+    current->slice_used = 0;
+    tree_insert(current);
+    current = NULL;
+  }
+
+  // Pick the process with the smallest virtual runtime
+  if (!current && leftmost) {
+    current = leftmost;
+    tree_erase(current);
+  }
+
+  // Nothing to schedule so return 0
+  if (!current) {
+    return 0;
+  }
+
+  // Execute the process for one unit of time
+  unsigned int pid = current->pid;
+  current->processed_time++;
+  current->vruntime++;
+  current->slice_used++;
+  update_min_vruntime();
+
+  // If the process has finished, remove it
+  if (current->processed_time == current->processing_time) {
+    free(current);
+    current = NULL;
+
+    // If in debug mode, print out the run queue after it has changed
+    if (debug) {
+      printf("Run queue after process with pid %d has completed:\n", pid);
+      print_runqueue();
+    }
+  }
+  return pid;
+}
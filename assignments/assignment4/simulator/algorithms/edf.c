@@ -0,0 +1,173 @@
+/*
+ * An implementation of preemptive Earliest-Deadline-First (EDF) scheduling.
+ * The ready queue is a binary min-heap keyed on deadline, so adding a process or
+ * scheduling a time step costs O(log n).
+ * Processes without a deadline run only when no process with a deadline is ready,
+ * in FCFS order.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The process details we're interested in for the EDF algorithm.*/
+typedef struct edf_process {
+  unsigned int pid;
+  unsigned int processing_time;
+  unsigned int arrival_time;
+  unsigned int processed_time;
+  unsigned int deadline;  // the deadline, or UINT_MAX if the process doesn't have one
+} edf_process;
+
+/* The heap of ready processes, with the process with the earliest deadline at index 0 */
+edf_process **heap = NULL;
+unsigned int heap_size = 0;
+unsigned int heap_capacity = 0;
+
+/*
+ * Determines whether process a should be scheduled before process b.
+ * parameters:
+ *   a - the first process to compare
+ *   b - the second process to compare
+ * returns:
+ *   TRUE if a has an earlier deadline than b, or the same deadline and an earlier arrival
+ *   time, or the same deadline and arrival time and a lower PID
+ */
+bool runs_before(const edf_process *a, const edf_process *b) {
+  if (a->deadline != b->deadline) {
+    return a->deadline < b->deadline;
+  }
+  if (a->arrival_time != b->arrival_time) {
+    return a->arrival_time < b->arrival_time;
+  }
+  return a->pid < b->pid;
+}
+
+/*
+ * Moves the process at the given heap position towards the root until its parent runs before it.
+ * parameters:
+ *   position - the heap position of the process to move
+ */
+void sift_up(unsigned int position) {
+  edf_process *process = heap[position];
+  while (position > 0) {
+    unsigned int parent = (position - 1) / 2;
+    if (!runs_before(process, heap[parent])) {
+      break;
+    }
+    heap[position] = heap[parent];
+    position = parent;
+  }
+  heap[position] = process;
+}
+
+/*
+ * Moves the process at the given heap position towards the leaves until it runs before both children.
+ * parameters:
+ *   position - the heap position of the process to move
+ */
+void sift_down(unsigned int position) {
+  edf_process *process = heap[position];
+  while (2 * position + 1 < heap_size) {
+    unsigned int child = 2 * position + 1;
+    if (child + 1 < heap_size && runs_before(heap[child + 1], heap[child])) {
+      child++;
+    }
+    if (!runs_before(heap[child], process)) {
+      break;
+    }
+    heap[position] = heap[child];
+    position = child;
+  }
+  heap[position] = process;
+}
+
+/*
+ * Prints out the ready queue in heap order.
+ */
+void print_heap() {
+  for (unsigned int i = 0; i < heap_size; i++) {
+    edf_process *process = heap[i];
+    printf("\tpid: %d, processing_time %d, arrival_time: %d, processed_time: %d, deadline: %u\n",
+        process->pid,
+        process->processing_time,
+        process->arrival_time,
+        process->processed_time,
+        process->deadline);
+  }
+}
+
+/*
+ * Adds the given process to the ready queue, indicating it is ready to be scheduled.
+ * The process is pushed on to the heap by its deadline.
+ * parameters:
+ *   process - the process to add to the ready queue
+ */
+void add_to_ready_queue(const process_initial process) {
+  // Construct the new edf_process
+  edf_process *new_process = malloc(sizeof(edf_process));
+  if (!new_process) {
+    perror("Failed to allocate memory for new process");
+    exit(1);
+  }
+  new_process->pid = process.pid;
+  new_process->processing_time = process.processing_time;
+  new_process->arrival_time = process.arrival_time;
+  new_process->processed_time = 0;
+  new_process->deadline = process.deadline == NO_DEADLINE ? UINT_MAX : process.deadline;
+
+  // Grow the heap (doubling, so growth is amortised O(1)) if required
+  if (heap_size == heap_capacity) {
+    heap_capacity = heap_capacity ? heap_capacity * 2 : 64;
+    heap = realloc(heap, heap_capacity * sizeof(edf_process *));
+    if (!heap) {
+      perror("Failed to allocate memory for ready queue");
+      exit(1);
+    }
+  }
+
+  heap[heap_size] = new_process;
+  heap_size++;
+  sift_up(heap_size - 1);
+
+  // If in debug mode, print out the ready queue after it has changed
+  if (debug) {
+    printf("Ready queue after adding process with pid %d:\n", process.pid);
+    print_heap();
+  }
+}
+
+/*
+ * Determines the next process to the scheduled.
+ * Implements EDF, meaning it will select the process with the earliest deadline,
+ * preempting the running process whenever a process with an earlier deadline arrives.
+ * Processes with the same deadline are selected in FCFS order (then lowest PID first).
+ * returns:
+ *   The PID of the process to be scheduled next, or 0 if no process should be scheduled
+ */
+unsigned int get_next_scheduled_process() {
+  if (heap_size == 0) {
+    return 0;
+  }
+
+  edf_process *next = heap[0];
+  unsigned int pid = next->pid;
+  next->processed_time++;
+
+  // If the process has finished, remove it from the heap
+  if (next->processed_time == next->processing_time) {
+    heap_size--;
+    if (heap_size > 0) {
+      heap[0] = heap[heap_size];
+      sift_down(0);
+    }
+    free(next);
+
+    // If in debug mode, print out the ready queue after it has changed
+    if (debug) {
+      printf("Ready queue after process with pid %d has completed:\n", pid);
+      print_heap();
+    }
+  }
+  return pid;
+}
@@ -135,3 +135,57 @@ unsigned int get_next_scheduled_process() {
   return 0;
 }
 
+/*
+ * Writes the process list to a checkpoint, so the simulation can be resumed (see scheduler.h).
+ * parameters:
+ *   fp - the checkpoint file to write to
+ * returns:
+ *   TRUE if the process list was written successfully, FALSE otherwise
+ */
+bool save_scheduler_state(FILE *fp) {
+  unsigned int count = 0;
+  for (fcfs_process *node = process_list.next_process; node; node = node->next_process) {
+    count++;
+  }
+  if (fwrite(&count, sizeof(count), 1, fp) != 1) {
+    return FALSE;
+  }
+  for (fcfs_process *node = process_list.next_process; node; node = node->next_process) {
+    unsigned int fields[4] = {node->pid, node->processing_time, node->arrival_time, node->processed_time};
+    if (fwrite(fields, sizeof(fields), 1, fp) != 1) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/*
+ * Reads in the process list written to a checkpoint by save_scheduler_state.
+ * parameters:
+ *   fp - the checkpoint file to read from
+ * returns:
+ *   TRUE if the process list was read in successfully, FALSE otherwise
+ */
+bool load_scheduler_state(FILE *fp) {
+  unsigned int count;
+  if (fread(&count, sizeof(count), 1, fp) != 1) {
+    return FALSE;
+  }
+  fcfs_process *end = &process_list;
+  for (unsigned int i = 0; i < count; i++) {
+    unsigned int fields[4];
+    fcfs_process *process = malloc(sizeof(fcfs_process));
+    if (!process || fread(fields, sizeof(fields), 1, fp) != 1) {
+      free(process);
+      return FALSE;
+    }
+    process->pid = fields[0];
+    process->processing_time = fields[1];
+    process->arrival_time = fields[2];
+    process->processed_time = fields[3];
+    process->next_process = NULL;
+    add_next(end, process);
+    end = process;
+  }
+  return TRUE;
+}
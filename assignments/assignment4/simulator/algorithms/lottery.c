@@ -0,0 +1,214 @@
+/*
+ * An implementation of lottery scheduling, a randomised proportional-share algorithm.
+ * At each time step a ticket is drawn at random and the process holding it runs, so each
+ * process receives processing time in proportion to its tickets on average.
+ * Tickets are held in a Fenwick (binary indexed) tree over process slots, so a draw and
+ * adding or removing a process each cost O(log n).
+ * Draws use a seeded xorshift64* generator, so a schedule always produces the same output.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The seed for the random number generator (must not be 0) */
+#define LOTTERY_SEED 240
+
+/* The process details we're interested in for the lottery algorithm.*/
+typedef struct lottery_process {
+  unsigned int pid;
+  unsigned int processing_time;
+  unsigned int arrival_time;
+  unsigned int processed_time;
+  unsigned int tickets;
+} lottery_process;
+
+/* The Fenwick tree of tickets per slot (1-indexed, so fenwick[0] is unused) */
+unsigned long *fenwick = NULL;
+
+/* The process in each slot (NULL if the slot is free) */
+lottery_process **slots = NULL;
+
+/* The number of slots (always a power of two) and the number in use */
+unsigned int num_slots = 0;
+unsigned int slots_used = 0;
+
+/* Slots freed by completed processes, available for reuse */
+unsigned int *free_slots = NULL;
+unsigned int num_free_slots = 0;
+
+/* The total tickets held by the ready processes */
+unsigned long total_tickets = 0;
+
+/* The state of the random number generator */
+unsigned long long rng_state = LOTTERY_SEED;
+
+/*
+ * Exits with an error message if memory could not be allocated.
+ * parameters:
+ *   ptr - the result of the allocation to check
+ */
+void check_allocation(void *ptr) {
+  if (!ptr) {
+    perror("Failed to allocate memory for lottery ready queue");
+    exit(1);
+  }
+}
+
+/*
+ * Generates the next pseudo-random number using xorshift64*.
+ * returns:
+ *   A pseudo-random 64-bit number
+ */
+unsigned long long next_random() {
+  rng_state ^= rng_state >> 12;
+  rng_state ^= rng_state << 25;
+  rng_state ^= rng_state >> 27;
+  return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Adds the given number of tickets to the given slot in the Fenwick tree.
+ * parameters:
+ *   slot - the (0-indexed) slot to change
+ *   delta - the number of tickets to add (may be negative)
+ */
+void fenwick_add(unsigned int slot, long delta) {
+  for (unsigned int i = slot + 1; i <= num_slots; i += i & -i) {
+    fenwick[i] += delta;
+  }
+}
+
+/*
+ * Finds the slot holding the given ticket, where tickets are numbered in slot order.
+ * parameters:
+ *   ticket - the ticket to find (less than total_tickets)
+ * returns:
+ *   The (0-indexed) slot of the process holding the ticket
+ */
+unsigned int fenwick_find(unsigned long ticket) {
+  unsigned int position = 0;
+  for (unsigned int step = num_slots; step > 0; step /= 2) {
+    if (position + step <= num_slots && fenwick[position + step] <= ticket) {
+      position += step;
+      ticket -= fenwick[position];
+    }
+  }
+  return position;
+}
+
+/*
+ * Doubles the number of slots, rebuilding the Fenwick tree in O(n).
+ */
+void grow_slots() {
+  unsigned int old_num_slots = num_slots;
+  num_slots = num_slots ? num_slots * 2 : 64;
+  slots = realloc(slots, num_slots * sizeof(lottery_process *));
+  check_allocation(slots);
+  free_slots = realloc(free_slots, num_slots * sizeof(unsigned int));
+  check_allocation(free_slots);
+  for (unsigned int i = old_num_slots; i < num_slots; i++) {
+    slots[i] = NULL;
+  }
+
+  free(fenwick);
+  fenwick = calloc(num_slots + 1, sizeof(unsigned long));
+  check_allocation(fenwick);
+  for (unsigned int i = 1; i <= num_slots; i++) {
+    fenwick[i] += slots[i - 1] ? slots[i - 1]->tickets : 0;
+    unsigned int parent = i + (i & -i);
+    if (parent <= num_slots) {
+      fenwick[parent] += fenwick[i];
+    }
+  }
+}
+
+/*
+ * Prints out the processes in each slot in use.
+ */
+void print_slots() {
+  printf("\ttotal_tickets: %lu\n", total_tickets);
+  for (unsigned int i = 0; i < slots_used; i++) {
+    lottery_process *process = slots[i];
+    if (process) {
+      printf("\tpid: %d, processing_time %d, arrival_time: %d, processed_time: %d, tickets: %d, slot: %d\n",
+          process->pid,
+          process->processing_time,
+          process->arrival_time,
+          process->processed_time,
+          process->tickets,
+          i);
+    }
+  }
+}
+
+/*
+ * Adds the given process to the ready queue, indicating it is ready to be scheduled.
+ * The process takes a free slot (reusing those of completed processes first) and its tickets
+ * are added to the Fenwick tree.
+ * parameters:
+ *   process - the process to add to the ready queue
+ */
+void add_to_ready_queue(const process_initial process) {
+  // Construct the new lottery_process
+  lottery_process *new_process = malloc(sizeof(lottery_process));
+  check_allocation(new_process);
+  new_process->pid = process.pid;
+  new_process->processing_time = process.processing_time;
+  new_process->arrival_time = process.arrival_time;
+  new_process->processed_time = 0;
+  new_process->tickets = process.tickets;
+
+  // Find a slot for the process
+  unsigned int slot;
+  if (num_free_slots > 0) {
+    slot = free_slots[--num_free_slots];
+  } else {
+    if (slots_used == num_slots) {
+      grow_slots();
+    }
+    slot = slots_used++;
+  }
+  slots[slot] = new_process;
+  fenwick_add(slot, process.tickets);
+  total_tickets += process.tickets;
+
+  // If in debug mode, print out the ready queue after it has changed
+  if (debug) {
+    printf("Ready queue after adding process with pid %d:\n", process.pid);
+    print_slots();
+  }
+}
+
+/*
+ * Determines the next process to the scheduled.
+ * Implements lottery scheduling, meaning it will draw a ticket at random and select the
+ * process holding it.
+ * returns:
+ *   The PID of the process to be scheduled next, or 0 if no process should be scheduled
+ */
+unsigned int get_next_scheduled_process() {
+  if (total_tickets == 0) {
+    return 0;
+  }
+
+  unsigned int slot = fenwick_find(next_random() % total_tickets);
+  lottery_process *next = slots[slot];
+  unsigned int pid = next->pid;
+  next->processed_time++;
+
+  // If the process has finished, remove its tickets and free its slot
+  if (next->processed_time == next->processing_time) {
+    fenwick_add(slot, -(long) next->tickets);
+    total_tickets -= next->tickets;
+    slots[slot] = NULL;
+    free_slots[num_free_slots++] = slot;
+    free(next);
+
+    // If in debug mode, print out the ready queue after it has changed
+    if (debug) {
+      printf("Ready queue after process with pid %d has completed:\n", pid);
+      print_slots();
+    }
+  }
+  return pid;
+}
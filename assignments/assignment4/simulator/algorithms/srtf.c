@@ -0,0 +1,273 @@
+/*
+ * An implementation of Shortest-Remaining-Time-First (SRTF) scheduling.
+ * The ready queue is an indexed binary min-heap keyed on remaining processing
+ * time (ties broken by the lowest PID), so adding a process or scheduling a
+ * time step costs O(log n). Each process records its own position in the heap,
+ * so memory is proportional to the number of ready processes, whatever their PIDs.
+ * SRTF minimises the average turnaround time for a single preemptive CPU, so
+ * it is used as the reference policy other algorithms are measured against.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The process details we're interested in for the SRTF algorithm.*/
+typedef struct srtf_process {
+  unsigned int pid;
+  unsigned int processing_time;
+  unsigned int arrival_time;
+  unsigned int processed_time;
+  unsigned int heap_index;
+} srtf_process;
+
+/* The heap of ready processes, with the process with the least remaining time at index 0 */
+srtf_process **heap = NULL;
+unsigned int heap_size = 0;
+unsigned int heap_capacity = 0;
+
+/*
+ * Exits with an error message if memory could not be allocated.
+ * parameters:
+ *   ptr - the result of the allocation to check
+ */
+void check_allocation(void *ptr) {
+  if (!ptr) {
+    perror("Failed to allocate memory for SRTF ready queue");
+    exit(1);
+  }
+}
+
+/*
+ * Determines the remaining processing time required by the given process.
+ * parameters:
+ *   process - the process to check
+ * returns:
+ *   The number of time units the process still needs
+ */
+unsigned int remaining_time(const srtf_process *process) {
+  return process->processing_time - process->processed_time;
+}
+
+/*
+ * Determines whether process a should be scheduled before process b.
+ * parameters:
+ *   a - the first process to compare
+ *   b - the second process to compare
+ * returns:
+ *   TRUE if a has less remaining time than b, or the same remaining time and a lower PID
+ */
+bool runs_before(const srtf_process *a, const srtf_process *b) {
+  unsigned int remaining_a = remaining_time(a);
+  unsigned int remaining_b = remaining_time(b);
+  return remaining_a < remaining_b || (remaining_a == remaining_b && a->pid < b->pid);
+}
+
+/*
+ * Places the given process at the given heap position, keeping its index up to date.
+ * parameters:
+ *   position - the heap position to fill
+ *   process - the process to store there
+ */
+void heap_set(unsigned int position, srtf_process *process) {
+  heap[position] = process;
+  process->heap_index = position;
+}
+
+/*
+ * Moves the process at the given heap position towards the root until its parent runs before it.
+ * parameters:
+ *   position - the heap position of the process to move
+ */
+void sift_up(unsigned int position) {
+  srtf_process *process = heap[position];
+  while (position > 0) {
+    unsigned int parent = (position - 1) / 2;
+    if (!runs_before(process, heap[parent])) {
+      break;
+    }
+    heap_set(position, heap[parent]);
+    position = parent;
+  }
+  heap_set(position, process);
+}
+
+/*
+ * Moves the process at the given heap position towards the leaves until it runs before both children.
+ * parameters:
+ *   position - the heap position of the process to move
+ */
+void sift_down(unsigned int position) {
+  srtf_process *process = heap[position];
+  while (2 * position + 1 < heap_size) {
+    unsigned int child = 2 * position + 1;
+    if (child + 1 < heap_size && runs_before(heap[child + 1], heap[child])) {
+      child++;
+    }
+    if (!runs_before(heap[child], process)) {
+      break;
+    }
+    heap_set(position, heap[child]);
+    position = child;
+  }
+  heap_set(position, process);
+}
+
+/*
+ * Removes the process at the given heap position, restoring the heap order.
+ * parameters:
+ *   position - the heap position of the process to remove
+ * returns:
+ *   The process that was removed
+ */
+srtf_process *heap_remove(unsigned int position) {
+  srtf_process *removed = heap[position];
+  heap_size--;
+  if (position < heap_size) {
+    heap_set(position, heap[heap_size]);
+    sift_down(position);
+    sift_up(position);
+  }
+  return removed;
+}
+
+/*
+ * Prints out the ready queue in heap order.
+ */
+void print_heap() {
+  for (unsigned int i = 0; i < heap_size; i++) {
+    srtf_process *process = heap[i];
+    printf("\tpid: %d, processing_time %d, arrival_time: %d, processed_time: %d, heap_index: %d\n",
+        process->pid,
+        process->processing_time,
+        process->arrival_time,
+        process->processed_time,
+        i);
+  }
+}
+
+/*
+ * Adds the given process to the heap, growing the heap if required.
+ * parameters:
+ *   process - the process to add
+ */
+void heap_insert(srtf_process *process) {
+  // Grow the heap (doubling, so growth is amortised O(1)) if required
+  if (heap_size == heap_capacity) {
+    heap_capacity = heap_capacity ? heap_capacity * 2 : 64;
+    heap = realloc(heap, heap_capacity * sizeof(srtf_process *));
+    check_allocation(heap);
+  }
+
+  // Add the new process as a leaf, then move it in to position
+  heap_set(heap_size, process);
+  heap_size++;
+  sift_up(heap_size - 1);
+}
+
+/*
+ * Adds the given process to the ready queue, indicating it is ready to be scheduled.
+ * The process is pushed on to the heap by its remaining processing time, then PID.
+ * parameters:
+ *   process - the process to add to the ready queue
+ */
+void add_to_ready_queue(const process_initial process) {
+  // Construct the new srtf_process
+  srtf_process *new_process = malloc(sizeof(srtf_process));
+  check_allocation(new_process);
+  new_process->pid = process.pid;
+  new_process->processing_time = process.processing_time;
+  new_process->arrival_time = process.arrival_time;
+  new_process->processed_time = 0;
+
+  heap_insert(new_process);
+
+  // If in debug mode, print out the ready queue after it has changed
+  if (debug) {
+    printf("Ready queue after adding process with pid %d:\n", process.pid);
+    print_heap();
+  }
+}
+
+/*
+ * Determines the next process to the scheduled.
+ * Implements SRTF, meaning it will select the process with the least remaining processing
+ * time, preempting the running process whenever a shorter process arrives.
+ * If two processes have the same remaining time, it will select the one with the lowest PID first.
+ * returns:
+ *   The PID of the process to be scheduled next, or 0 if no process should be scheduled
+ */
+unsigned int get_next_scheduled_process() {
+  if (heap_size == 0) {
+    return 0;
+  }
+
+  srtf_process *next = heap[0];
+  unsigned int pid = next->pid;
+  next->processed_time++;
+
+  if (next->processed_time == next->processing_time) {
+    // The process has finished, so remove it from the heap
+    heap_remove(next->heap_index);
+    free(next);
+
+    // If in debug mode, print out the ready queue after it has changed
+    if (debug) {
+      printf("Ready queue after process with pid %d has completed:\n", pid);
+      print_heap();
+    }
+  } else {
+    // Its remaining time has decreased, so it can only move towards the root
+    sift_up(next->heap_index);
+  }
+  return pid;
+}
+
+/*
+ * Writes the heap to a checkpoint, so the simulation can be resumed (see scheduler.h).
+ * parameters:
+ *   fp - the checkpoint file to write to
+ * returns:
+ *   TRUE if the heap was written successfully, FALSE otherwise
+ */
+bool save_scheduler_state(FILE *fp) {
+  if (fwrite(&heap_size, sizeof(heap_size), 1, fp) != 1) {
+    return FALSE;
+  }
+  for (unsigned int i = 0; i < heap_size; i++) {
+    srtf_process *process = heap[i];
+    unsigned int fields[4] = {process->pid, process->processing_time, process->arrival_time, process->processed_time};
+    if (fwrite(fields, sizeof(fields), 1, fp) != 1) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/*
+ * Reads in the heap written to a checkpoint by save_scheduler_state.
+ * The processes were written in heap order, so inserting them in the same order rebuilds the same heap.
+ * parameters:
+ *   fp - the checkpoint file to read from
+ * returns:
+ *   TRUE if the heap was read in successfully, FALSE otherwise
+ */
+bool load_scheduler_state(FILE *fp) {
+  unsigned int count;
+  if (fread(&count, sizeof(count), 1, fp) != 1) {
+    return FALSE;
+  }
+  for (unsigned int i = 0; i < count; i++) {
+    unsigned int fields[4];
+    if (fread(fields, sizeof(fields), 1, fp) != 1) {
+      return FALSE;
+    }
+    srtf_process *process = malloc(sizeof(srtf_process));
+    check_allocation(process);
+    process->pid = fields[0];
+    process->processing_time = fields[1];
+    process->arrival_time = fields[2];
+    process->processed_time = fields[3];
+    heap_insert(process);
+  }
+  return TRUE;
+}
@@ -0,0 +1,189 @@
+/*
+ * An implementation of stride scheduling, a deterministic proportional-share algorithm.
+ * Each process has a stride inversely proportional to its number of tickets, and a pass
+ * value that advances by its stride each time it runs. The process with the smallest pass
+ * (ties broken by the lowest PID) runs next, so over time each process receives processing
+ * time in proportion to its tickets.
+ * The ready queue is a binary min-heap of pass values, so each operation costs O(log n).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The numerator used to calculate strides (large, so integer division stays precise) */
+#define STRIDE1 (1UL << 20)
+
+/* The process details we're interested in for the stride algorithm.*/
+typedef struct stride_process {
+  unsigned int pid;
+  unsigned int processing_time;
+  unsigned int arrival_time;
+  unsigned int processed_time;
+  unsigned int tickets;
+  unsigned long stride;  // how far pass advances each time the process runs
+  unsigned long pass;  // the virtual time at which the process should next run
+} stride_process;
+
+/* The heap of ready processes, with the process with the smallest pass at index 0 */
+stride_process **heap = NULL;
+unsigned int heap_size = 0;
+unsigned int heap_capacity = 0;
+
+/* The total tickets held by the ready processes */
+unsigned long global_tickets = 0;
+
+/* The virtual time of the system, which advances by STRIDE1 / global_tickets each time step */
+unsigned long global_pass = 0;
+
+/*
+ * Determines whether process a should be scheduled before process b.
+ * parameters:
+ *   a - the first process to compare
+ *   b - the second process to compare
+ * returns:
+ *   TRUE if a has a smaller pass than b, or the same pass and a lower PID
+ */
+bool runs_before(const stride_process *a, const stride_process *b) {
+  return a->pass < b->pass || (a->pass == b->pass && a->pid < b->pid);
+}
+
+/*
+ * Moves the process at the given heap position towards the root until its parent runs before it.
+ * parameters:
+ *   position - the heap position of the process to move
+ */
+void sift_up(unsigned int position) {
+  stride_process *process = heap[position];
+  while (position > 0) {
+    unsigned int parent = (position - 1) / 2;
+    if (!runs_before(process, heap[parent])) {
+      break;
+    }
+    heap[position] = heap[parent];
+    position = parent;
+  }
+  heap[position] = process;
+}
+
+/*
+ * Moves the process at the given heap position towards the leaves until it runs before both children.
+ * parameters:
+ *   position - the heap position of the process to move
+ */
+void sift_down(unsigned int position) {
+  stride_process *process = heap[position];
+  while (2 * position + 1 < heap_size) {
+    unsigned int child = 2 * position + 1;
+    if (child + 1 < heap_size && runs_before(heap[child + 1], heap[child])) {
+      child++;
+    }
+    if (!runs_before(heap[child], process)) {
+      break;
+    }
+    heap[position] = heap[child];
+    position = child;
+  }
+  heap[position] = process;
+}
+
+/*
+ * Prints out the ready queue in heap order.
+ */
+void print_heap() {
+  printf("\tglobal_pass: %lu, global_tickets: %lu\n", global_pass, global_tickets);
+  for (unsigned int i = 0; i < heap_size; i++) {
+    stride_process *process = heap[i];
+    printf("\tpid: %d, processing_time %d, arrival_time: %d, processed_time: %d, tickets: %d, pass: %lu\n",
+        process->pid,
+        process->processing_time,
+        process->arrival_time,
+        process->processed_time,
+        process->tickets,
+        process->pass);
+  }
+}
+
+/*
+ * Adds the given process to the ready queue, indicating it is ready to be scheduled.
+ * A new process starts one stride after the global pass, so it joins the existing
+ * processes at the same point in virtual time.
+ * parameters:
+ *   process - the process to add to the ready queue
+ */
+void add_to_ready_queue(const process_initial process) {
+  // Construct the new stride_process
+  stride_process *new_process = malloc(sizeof(stride_process));
+  if (!new_process) {
+    perror("Failed to allocate memory for new process");
+    exit(1);
+  }
+  new_process->pid = process.pid;
+  new_process->processing_time = process.processing_time;
+  new_process->arrival_time = process.arrival_time;
+  new_process->processed_time = 0;
+  new_process->tickets = process.tickets;
+  new_process->stride = STRIDE1 / process.tickets;
+  new_process->pass = global_pass + new_process->stride;
+
+  // Grow the heap (doubling, so growth is amortised O(1)) if required
+  if (heap_size == heap_capacity) {
+    heap_capacity = heap_capacity ? heap_capacity * 2 : 64;
+    heap = realloc(heap, heap_capacity * sizeof(stride_process *));
+    if (!heap) {
+      perror("Failed to allocate memory for ready queue");
+      exit(1);
+    }
+  }
+
+  heap[heap_size] = new_process;
+  heap_size++;
+  sift_up(heap_size - 1);
+  global_tickets += process.tickets;
+
+  // If in debug mode, print out the ready queue after it has changed
+  if (debug) {
+    printf("Ready queue after adding process with pid %d:\n", process.pid);
+    print_heap();
+  }
+}
+
+/*
+ * Determines the next process to the scheduled.
+ * Implements stride scheduling, meaning it will select the process with the smallest pass
+ * and then advance that process's pass by its stride.
+ * If two processes have the same pass, it will select the one with the lowest PID first.
+ * returns:
+ *   The PID of the process to be scheduled next, or 0 if no process should be scheduled
+ */
+unsigned int get_next_scheduled_process() {
+  if (heap_size == 0) {
+    return 0;
+  }
+
+  stride_process *next = heap[0];
+  unsigned int pid = next->pid;
+  next->processed_time++;
+  global_pass += STRIDE1 / global_tickets;
+
+  if (next->processed_time == next->processing_time) {
+    // The process has finished, so remove it from the heap
+    global_tickets -= next->tickets;
+    heap_size--;
+    if (heap_size > 0) {
+      heap[0] = heap[heap_size];
+      sift_down(0);
+    }
+    free(next);
+
+    // If in debug mode, print out the ready queue after it has changed
+    if (debug) {
+      printf("Ready queue after process with pid %d has completed:\n", pid);
+      print_heap();
+    }
+  } else {
+    // Advance the process's pass, moving it back in to position
+    next->pass += next->stride;
+    sift_down(0);
+  }
+  return pid;
+}
@@ -0,0 +1,270 @@
+/*
+ * A microbenchmark for the hot paths of a process scheduling algorithm.
+ * Drives add_to_ready_queue and get_next_scheduled_process directly (without the
+ * simulator's per-time-step output) at a range of queue depths, writing the cost of
+ * each call, the peak RSS and the number of allocations as CSV.
+ * Each depth is measured in a separate child process, so every measurement starts
+ * from a fresh ready queue.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+#include <limits.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+// The interface the scheduling algorithm implements
+#include "scheduler.h"
+
+// The benchmark never runs in debug mode, so the algorithm produces no output
+bool debug = FALSE;
+
+/* The number of allocations made by the algorithm, and the total bytes requested */
+unsigned long allocations = 0;
+unsigned long allocated_bytes = 0;
+
+/*
+ * Allocates memory in the same way as malloc, counting the allocation.
+ */
+void *counting_malloc(size_t size) {
+  allocations++;
+  allocated_bytes += size;
+  return malloc(size);
+}
+
+/*
+ * Allocates memory in the same way as calloc, counting the allocation.
+ */
+void *counting_calloc(size_t count, size_t size) {
+  allocations++;
+  allocated_bytes += count * size;
+  return calloc(count, size);
+}
+
+/*
+ * Reallocates memory in the same way as realloc, counting the allocation.
+ */
+void *counting_realloc(void *ptr, size_t size) {
+  allocations++;
+  allocated_bytes += size;
+  return realloc(ptr, size);
+}
+
+// Count the algorithm's allocations (its standard headers have already been included above, so aren't affected)
+#define malloc(size) counting_malloc(size)
+#define calloc(count, size) counting_calloc(count, size)
+#define realloc(ptr, size) counting_realloc(ptr, size)
+
+// The file where the functions declared in scheduler.h need to be defined
+#include "scheduler.c"
+
+#undef malloc
+#undef calloc
+#undef realloc
+
+/* The largest queue depth to measure by default */
+const unsigned int DEFAULT_MAX_DEPTH = 1000000;
+
+/* The number of calls to get_next_scheduled_process to time at each depth */
+const unsigned int NEXT_CALLS = 100000;
+
+/* The number of seconds a single depth may take before it is abandoned */
+const unsigned int DEFAULT_TIME_LIMIT = 60;
+
+/* The results of measuring a single queue depth */
+typedef struct bench_result {
+  double add_ns;  // the average time taken by add_to_ready_queue
+  double next_ns;  // the average time taken by get_next_scheduled_process
+  unsigned long next_calls;  // the number of calls to get_next_scheduled_process timed
+  long peak_rss_kb;  // the peak resident set size of the process
+  unsigned long allocations;  // the number of allocations made by the algorithm
+  unsigned long allocated_bytes;  // the number of bytes allocated by the algorithm
+} bench_result;
+
+/* The state of the random number generator used to generate processes */
+unsigned long long bench_rng_state = 240;
+
+/*
+ * Generates the next pseudo-random number using xorshift64*.
+ * returns:
+ *   A pseudo-random 64-bit number
+ */
+unsigned long long bench_random() {
+  bench_rng_state ^= bench_rng_state >> 12;
+  bench_rng_state ^= bench_rng_state << 25;
+  bench_rng_state ^= bench_rng_state >> 27;
+  return bench_rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Determines the number of nanoseconds between two times.
+ * parameters:
+ *   start - the earlier time
+ *   end - the later time
+ * returns:
+ *   The number of nanoseconds from start to end
+ */
+double elapsed_ns(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+/*
+ * Fills the ready queue with the given number of processes, then times calls to
+ * get_next_scheduled_process with the queue at (close to) that depth.
+ * Processes arrive one per time step, in PID order, with a random processing time
+ * between 1 and 10, the default number of tickets and a deadline a few times their
+ * processing time after they arrive.
+ * parameters:
+ *   depth - the number of processes to add to the ready queue
+ * returns:
+ *   The measurements taken
+ */
+bench_result measure_depth(unsigned int depth) {
+  bench_result result = {0, 0, 0, 0, 0, 0};
+  struct timespec start, end;
+
+  // Time adding the processes
+  unsigned long total_processing_time = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (unsigned int i = 0; i < depth; i++) {
+    unsigned int processing_time = 1 + bench_random() % 10;
+    process_initial process = {i + 1, processing_time, i, 100, i + 4 * processing_time};
+    add_to_ready_queue(process);
+    total_processing_time += processing_time;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  result.add_ns = elapsed_ns(start, end) / depth;
+
+  // Time scheduling processes (never emptying the queue, so the depth stays close to the one given)
+  result.next_calls = total_processing_time / 2 < NEXT_CALLS ? total_processing_time / 2 : NEXT_CALLS;
+  if (result.next_calls == 0) {
+    result.next_calls = 1;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (unsigned long i = 0; i < result.next_calls; i++) {
+    get_next_scheduled_process();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  result.next_ns = elapsed_ns(start, end) / result.next_calls;
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  result.peak_rss_kb = usage.ru_maxrss;
+  result.allocations = allocations;
+  result.allocated_bytes = allocated_bytes;
+  return result;
+}
+
+/*
+ * Measures the given depth in a child process, so the algorithm starts with an empty ready queue.
+ * parameters:
+ *   depth - the number of processes to add to the ready queue
+ *   time_limit - the number of seconds the child may run before it is killed
+ *   result - where to store the measurements taken
+ * returns:
+ *   TRUE if the measurements were taken, FALSE if the child failed or ran out of time
+ */
+bool measure_depth_in_child(unsigned int depth, unsigned int time_limit, bench_result *result) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    perror("Unable to create pipe");
+    return FALSE;
+  }
+
+  fflush(stdout);
+  pid_t child = fork();
+  if (child < 0) {
+    perror("Unable to fork");
+    return FALSE;
+  }
+  if (child == 0) {
+    close(fds[0]);
+    alarm(time_limit);
+    bench_result measured = measure_depth(depth);
+    ssize_t written = write(fds[1], &measured, sizeof(measured));
+    _exit(written == sizeof(measured) ? 0 : 1);
+  }
+
+  close(fds[1]);
+  ssize_t count = read(fds[0], result, sizeof(*result));
+  close(fds[0]);
+  int status;
+  waitpid(child, &status, 0);
+  return count == sizeof(*result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/*
+ * Prints out usage information for the program.
+ * parameters:
+ *   cmd - the command used to start the program
+ *   error - the error message that should be displayed (ignored if NULL)
+ */
+void usage(char *cmd, char *error) {
+  if (error) {
+    fprintf(stderr, "Error: %s\n\n", error);
+  }
+
+  fprintf(stderr, "Usage: %s [-h] [-m MAX_DEPTH] [-t SECONDS] NAME\n", cmd);
+  fprintf(stderr, "Where:\n");
+  fprintf(stderr, "\t-h\tspecifies that the CSV header should be written first\n");
+  fprintf(stderr, "\t-m\tis the largest queue depth to measure (defaults to %u)\n", DEFAULT_MAX_DEPTH);
+  fprintf(stderr, "\t-t\tis the number of seconds each depth may take before larger depths are skipped (defaults to %u)\n", DEFAULT_TIME_LIMIT);
+  fprintf(stderr, "\tNAME\tis the name of the algorithm, written in the first column of the CSV\n");
+}
+
+/*
+ *  Program entry point.
+ *  Measures queue depths 10, 100, ... up to the maximum depth, writing a CSV row for each.
+ */
+int main(int argc, char *argv[]) {
+  // Check arguments
+  bool header = FALSE;
+  unsigned int max_depth = DEFAULT_MAX_DEPTH;
+  unsigned int time_limit = DEFAULT_TIME_LIMIT;
+  int opt;
+  while ((opt = getopt(argc, argv, "hm:t:")) != -1) {
+    switch (opt) {
+      case 'h':
+        header = TRUE;
+        break;
+      case 'm':
+        max_depth = strtoul(optarg, NULL, 10);
+        break;
+      case 't':
+        time_limit = strtoul(optarg, NULL, 10);
+        break;
+      default:
+        usage(argv[0], "Invalid command line arguments");
+        return -1;
+    }
+  }
+  if (optind != argc - 1 || max_depth < 1 || time_limit < 1) {
+    usage(argv[0], "Invalid command line arguments");
+    return -1;
+  }
+  char *name = argv[optind];
+
+  if (header) {
+    printf("algorithm,depth,add_ns,next_ns,next_calls,peak_rss_kb,allocations,allocated_bytes,status\n");
+  }
+  bool failed = FALSE;
+  for (unsigned long depth = 10; depth <= max_depth; depth *= 10) {
+    bench_result result;
+    if (failed) {
+      // Larger depths would take even longer, so skip them
+      printf("%s,%lu,,,,,,,skipped\n", name, depth);
+    } else if (measure_depth_in_child(depth, time_limit, &result)) {
+      printf("%s,%lu,%.1f,%.1f,%lu,%ld,%lu,%lu,ok\n", name, depth, result.add_ns, result.next_ns, result.next_calls,
+          result.peak_rss_kb, result.allocations, result.allocated_bytes);
+    } else {
+      failed = TRUE;
+      printf("%s,%lu,,,,,,,failed\n", name, depth);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,184 @@
+#!/usr/bin/env bash
+
+set -Eeuo pipefail
+trap cleanup SIGINT SIGTERM ERR EXIT
+
+usage() {
+  cat <<EOF
+Usage: $(basename "${BASH_SOURCE[0]}") [-h] [-v] [-b bench] [-u submission] [-o output] [-m max_depth] [-t timeout] algorithm1 [algorithmN...]
+
+Measures the cost of the scheduling algorithms' add_to_ready_queue and get_next_scheduled_process functions at
+queue depths from 10 up to the maximum depth, along with peak RSS and the number of allocations, appending the
+results to a CSV file so they can be compared over time.
+
+Available options:
+
+-h, --help             Print this help and exit
+-v, --verbose          Print script debug info
+-b, --bench            Path to a C file that implements the benchmark driver (defaults to "bench.c")
+-u, --submission       Path to a directory containing the algorithms to benchmark (searched recursively) (defaults to "submissions/submission")
+-o, --output           Path to the CSV file the results are appended to (defaults to "output/benchmark_DATE.csv")
+-m, --max-depth        The largest queue depth to measure (defaults to 1000000)
+-t, --timeout          The number of seconds each depth may take before larger depths are skipped (defaults to 60)
+
+algorithm1 - algorithmN are the algorithms to benchmark (e.g., "fcfs" will benchmark the fcfs.c in the submission)
+
+Example:
+$(basename "${BASH_SOURCE[0]}") -u algorithms fcfs srtf
+
+will benchmark "algorithms/fcfs.c" and "algorithms/srtf.c", writing the results to "output/benchmark_DATE.csv"
+
+EOF
+}
+
+# Set up a fresh benchmark in a temporary directory (name of which will be stored in $bench_dir)
+# Parameters:
+#  $1 The directory containing the file to be used as the scheduler (searched recursively)
+#  $2 The name of the algorithm to search for (will search for ${2}.c in $1)
+# Returns 0 if the benchmark is compiled without issue, or 1 if there is a failure
+setup_bench() {
+  local submission="${1}"
+  local algorithm="${2}"
+
+  bench_dir=$(mktemp -d) && pushd "${bench_dir}" &> /dev/null || return 1
+  cp "${bench}" "$(dirname "${bench}")"/scheduler.h "${bench_dir}/" || return 1
+  find "${submission}" -name "${algorithm}".c -type f -exec cp {} "${bench_dir}"/"scheduler.c" \; || return 1
+  [[ -f scheduler.c ]] || return 1
+  gcc -Wall -O2 -o bench "$(basename "${bench}")" &> /dev/null && [[ -x bench ]] || return 1
+  return 0
+}
+
+# Remove a benchmark set up by setup_bench, if possible
+teardown_bench() {
+  if ! [[ -z "${bench_dir-}" ]] && [[ -d "${bench_dir}" ]]
+    then
+      popd &> /dev/null
+      rm -R "${bench_dir}" || warn "Unable to remove ${bench_dir}"
+  fi
+  bench_dir=""
+}
+
+# Main part of program
+main() {
+  for algorithm in "${args[@]}"
+  do
+    if setup_bench "${submission}" "${algorithm}"
+    then
+      info "Benchmarking ${algorithm}"
+      local header=""
+      [[ -s "${output}" ]] || header="-h"
+      ./bench ${header} -m "${max_depth}" -t "${timeout}" "${algorithm}" | tee -a "${output}"
+    else
+      error "Unable to set up benchmark with ${algorithm} from $(basename "${submission}")"
+    fi
+    teardown_bench
+  done
+  success "Results written to ${output}"
+}
+
+parse_params() {
+  # default values of variables set from params
+  bench="bench.c"
+  submission="submissions/submission"
+  output="output/benchmark_$(date -u "+%Y-%m-%d_%H-%M-%S").csv"
+  max_depth=1000000
+  timeout=60
+
+  while :; do
+    case "${1-}" in
+    -h | --help) usage && exit ;;
+    -v | --verbose) set -x ;;
+    --no-color) NO_COLOR=1 && setup_colors ;;
+    -b | --bench)
+      bench="${2-}"
+      shift
+      ;;
+    -u | --submission)
+      submission="${2-}"
+      shift
+      ;;
+    -o | --output)
+      output="${2-}"
+      shift
+      ;;
+    -m | --max-depth)
+      max_depth="${2-}"
+      shift
+      ;;
+    -t | --timeout)
+      timeout="${2-}"
+      shift
+      ;;
+    -?*) usage_die "Unknown option: $1" ;;
+    *) break ;;
+    esac
+    shift
+  done
+
+  args=("$@")
+
+  # check required params and arguments
+  [[ ${#args[@]} -eq 0 ]] && usage_die "At least one algorithm is required"
+  [[ "${max_depth}" =~ ^[0-9]+$ ]] || usage_die "max_depth must be an integer (${max_depth} is not)"
+  [[ "${timeout}" =~ ^[0-9]+$ ]] || usage_die "timeout must be an integer (${timeout} is not)"
+
+  # create required output directories
+  mkdir -p "$(dirname "${output}")"
+
+  # ensure required files/locations exist
+  bench=$(realpath "${bench}")
+  submission=$(realpath "${submission}")
+  output=$(realpath "${output}")
+  [[ -f "${bench}" ]] || usage_die "bench must be a regular file (${bench} is not)"
+
+  return 0
+}
+
+cleanup() {
+  trap - SIGINT SIGTERM ERR EXIT
+  teardown_bench
+}
+
+setup_colors() {
+  if [[ -t 2 ]] && [[ -z "${NO_COLOR-}" ]] && [[ "${TERM-}" != "dumb" ]]; then
+    NOFORMAT='\033[0m' RED='\033[0;31m' GREEN='\033[0;32m' ORANGE='\033[0;33m' BLUE='\033[0;34m' PURPLE='\033[0;35m' CYAN='\033[0;36m' YELLOW='\033[1;33m'
+  else
+    NOFORMAT='' RED='' GREEN='' ORANGE='' BLUE='' PURPLE='' CYAN='' YELLOW=''
+  fi
+}
+
+msg() {
+  echo >&2 -e "${1-}"
+}
+
+success() {
+  msg "${GREEN}Success:${NOFORMAT} ${1}"
+}
+
+info() {
+  msg "${BLUE}Info:${NOFORMAT} ${1}"
+}
+
+warn() {
+  msg "${ORANGE}Warning:${NOFORMAT} ${1}"
+}
+
+error() {
+  msg "${RED}Error:${NOFORMAT} ${1}"
+}
+
+die() {
+  local msg=$1
+  local code=${2-1}  # default exit status 1
+  error "$msg\n"
+  exit "$code"
+}
+
+usage_die() {
+  usage
+  die "$@"
+}
+
+setup_colors
+parse_params "$@"
+main "$@"
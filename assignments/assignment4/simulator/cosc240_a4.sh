@@ -5,7 +5,7 @@ trap cleanup SIGINT SIGTERM ERR EXIT
 
 usage() {
   cat <<EOF
-Usage: $(basename "${BASH_SOURCE[0]}") [-h] [-v] [-d] [-s simulator] [-o output] [-e schedules] [-l solution] [-u submissions] [-k] [-n] [-a] [-1] [-t timeout] [-m marks] [-c competition | algorithm1] [algorithmN...]
+Usage: $(basename "${BASH_SOURCE[0]}") [-h] [-v] [-d] [-s simulator] [-o output] [-e schedules] [-l solution] [-u submissions] [-k] [-n] [-a] [-1] [-i] [-t timeout] [-j jobs] [-b build_cache] [-O] [-f] [-r] [-M memory] [-D] [-m marks] [-c competition | algorithm1] [algorithmN...]
 
 A program that does the following tasks for the COSC240 scheduling assessment:
 
@@ -13,7 +13,7 @@ A program that does the following tasks for the COSC240 scheduling assessment:
 * Generate output from different submission's scheduling algorithms
 * Compare output from different submission's scheduling algorithms to the expected output
 * Collect average turnaround times from different submissions into a single location
-* Rank averages to give a score for different submissions
+* Rank averages to give a score for different submissions (and compare them to the optimal averages given by SRPT)
 
 Available options:
 
@@ -26,10 +26,19 @@ Available options:
 -l, --solution         Path to solution code that produces the correct outputs (defaults to "algorithms")
 -u, --submissions      Path to a directory that contains extracted submissions (default) or a single submission (when combined with the -1 option) (defaults to "submissions")
 -k, --collect          Collect schedules from each submission into the schedules directory (by default this doesn't happen)
+-i, --ignore-order     When collecting schedules, treat schedules that only differ in the order of their processes as duplicates (by default the order matters)
 -n, --no-generate      Do not generate output for the submissions (defaults to generating output)
 -a, --generate-answers Generate known correct output from the solution code (see "-l" option) (default to not generating known correct output)
 -1, --single           Treat submissions as a single submission (defaults to assuming submissions is a directory containing multiple submissions)
 -t, --timeout          The timeout to use when executing the simulator (defaults to "1m" for 1 minute)
+-b, --build-cache      Path to a directory of simulators built previously, by a hash of their source and compiler flags, so unchanged code isn't rebuilt (defaults to ".build_cache" in the output directory, created when first needed)
+    --no-build-cache   Always build the simulator (without using or adding to the build cache)
+-O, --optimise         Build the simulator with optimisation (-O2) (defaults to no optimisation)
+-f, --force            Regenerate every output (by default, only the outputs whose simulator, algorithm, schedule or settings have changed since they were generated are regenerated, as recorded in a manifest in the output directory)
+-r, --limit            Run the simulator with run_limited, which caps its CPU time (at the timeout), address space (see "-M" option) and output size, and records the CPU time, peak memory and context switches it used alongside its summary (defaults to only using the timeout)
+-M, --memory           The address space in megabytes the simulator may use when run with limits (defaults to 1024)
+-j, --jobs             The number of simulators to build and run at once (defaults to 1; results are still reported in the same order, and debug mode always uses 1)
+-D, --daemon           Build each algorithm as a module, and run every simulation through a single simulator service (see the --serve option of the simulator) with up to "jobs" workers, rather than starting a simulator for each schedule (cannot be combined with "-r", and debug mode never uses it)
 -m, --marks            The marks attainable for correctly generating the output for each algorithm (defaults to 0, meaning marks are not output, and any generated output is not compared to the solution's output; if a larger integer is used, it calculates the marks as a percentage of correct outputs multiplied by this value)
 -c, --competition      The marks attainable for winning the competition (if 0, competition is not run) (defaults to 0)
 
@@ -57,7 +66,24 @@ will execute the simulator for each "custom.c" implemented in each subdirectory
 EOF
 }
 
+# Prints the flags the simulator is compiled with
+compiler_flags() {
+  local flags="-Wall -pthread"
+  "${optimise}" && flags="${flags} -O2"
+  echo "${flags}"
+}
+
+# Prints a hash of the simulator that would be built with the given algorithm, which changes whenever the simulator, the
+# algorithm, the compiler flags or the compiler do
+# Parameters:
+#   $1 The C file that implements the algorithm (if it doesn't exist, the hash is of the simulator without it)
+simulator_hash() {
+  { sha256sum < "${simulator}" && sha256sum < "$(dirname "${simulator}")"/scheduler.h && { [[ -f "${1}" ]] && sha256sum < "${1}" || echo "none"; } && compiler_flags && gcc -dumpfullversion -dumpversion; } | sha256sum | cut -d " " -f 1
+}
+
 # Set up a fresh simulator in a temporary directory (name of which will be stored in $sim_dir)
+# If a simulator has already been built from the same source files with the same compiler and flags, it is copied
+# from $build_cache instead of being compiled (and newly compiled simulators are added to $build_cache)
 # Parameters:
 #  $1 The directory containing the file to be used as the scheduler (searched recursively)
 #  $2 The name of the algorithm to search for (will search for ${2}.c in $1)
@@ -65,14 +91,33 @@ EOF
 setup_simulator() {
   local submission="${1}"
   local algorithm="${2}"
+  local flags=$(compiler_flags)
 
   sim_dir=$(mktemp -d) && pushd "${sim_dir}" &> /dev/null || return 1
-  cp "${simulator}" "${sim_dir}/" && find "${submission}" -name "${algorithm}".c -type f -exec cp {} "${sim_dir}"/"scheduler.c" \; || return 1
+  cp "${simulator}" "$(dirname "${simulator}")"/scheduler.h "${sim_dir}/" && find "${submission}" -name "${algorithm}".c -type f -exec cp {} "${sim_dir}"/"scheduler.c" \; || return 1
+  [[ -f scheduler.c ]] || return 1
+
+  local cached=""
+  if ! [[ -z "${build_cache}" ]]
+  then
+    cached="${build_cache}"/$(simulator_hash scheduler.c)
+    if [[ -x "${cached}" ]] && cp "${cached}" simulator
+    then
+      return 0
+    fi
+  fi
+
   if "${debug}"
   then
-    gcc -Wall -o simulator simulator.c && [[ -x simulator ]] || return 1
+    gcc ${flags} -o simulator simulator.c -ldl && [[ -x simulator ]] || return 1
   else
-    gcc -Wall -o simulator simulator.c &> /dev/null && [[ -x simulator ]] || return 1
+    gcc ${flags} -o simulator simulator.c -ldl &> /dev/null && [[ -x simulator ]] || return 1
+  fi
+
+  # add the simulator to the cache (renaming it in to place, so workers building the same simulator don't clash)
+  if ! [[ -z "${cached}" ]]
+  then
+    mkdir -p "${build_cache}" && cp simulator "${cached}.${BASHPID}" && mv "${cached}.${BASHPID}" "${cached}" || warn "Unable to add the simulator to ${build_cache}"
   fi
   return 0
 }
@@ -86,42 +131,163 @@ teardown_simulator() {
   fi
 }
 
+# Builds run_limited (in a temporary directory), for running the simulator with limits on its resources
+setup_runner() {
+  runner_dir=$(mktemp -d)
+  runner="${runner_dir}"/run_limited
+  gcc -O2 -o "${runner}" "${script_dir}"/run_limited.c &> /dev/null && [[ -x "${runner}" ]] || return 1
+}
+
+# Builds the given algorithm from the given submission as a module for the simulator service (see module.c), in the
+# same way as setup_simulator (including the build cache), for process_tasks
+# Parameters:
+#   $1 The directory containing the submission
+#   $2 The algorithm to build
+#   $3 Where to put the module (it is left out if the build fails)
+build_module() {
+  local module_dir=$(mktemp -d)
+  local flags=$(compiler_flags)
+
+  cp "${script_dir}"/module.c "$(dirname "${simulator}")"/scheduler.h "${module_dir}"/ && find "${1}" -name "${2}".c -type f -exec cp {} "${module_dir}"/scheduler.c \; || true
+  if [[ -f "${module_dir}"/scheduler.c ]]
+  then
+    local cached=""
+    if ! [[ -z "${build_cache}" ]]
+    then
+      cached="${build_cache}"/$({ simulator_hash "${module_dir}"/scheduler.c && sha256sum < "${module_dir}"/module.c; } | sha256sum | cut -d " " -f 1).so
+    fi
+    if [[ -n "${cached}" ]] && [[ -f "${cached}" ]]
+    then
+      cp "${cached}" "${3}" || true
+    elif gcc ${flags} -shared -fPIC -fvisibility=hidden -o "${module_dir}"/module.so "${module_dir}"/module.c &> /dev/null
+    then
+      mv "${module_dir}"/module.so "${3}"
+      if [[ -n "${cached}" ]]
+      then
+        mkdir -p "${build_cache}" && cp "${3}" "${cached}.${BASHPID}" && mv "${cached}.${BASHPID}" "${cached}" || warn "Unable to add the module to ${build_cache}"
+      fi
+    fi
+  fi
+  rm -R "${module_dir}" || warn "Unable to remove ${module_dir}"
+}
+
+# Starts the simulator service (built with the solution's fcfs, which is never used) on ${work_dir}/socket with the
+# given modules, in the background (its process ID is stored in $daemon_pid), and builds simulator_client to send it jobs
+# Parameters:
+#   $@ The modules to load
+# Returns 0 once the service is listening, or 1 if it could not be started
+start_daemon() {
+  local modules=()
+  for module in "$@"
+  do
+    modules+=(-m "${module}")
+  done
+
+  build_task "${solutions}" "fcfs" "${work_dir}"
+  [[ -x "${work_dir}"/simulator ]] || return 1
+  gcc -O2 -o "${work_dir}"/simulator_client "${script_dir}"/simulator_client.c &> /dev/null || return 1
+  # (started from a subshell, so it isn't one of the workers that wait_for_worker counts)
+  daemon_pid=$( "${work_dir}"/simulator -j "${jobs}" "${modules[@]}" --serve "${work_dir}"/socket 2> "${work_dir}"/daemon.log > /dev/null & echo $! )
+  until [[ -S "${work_dir}"/socket ]]
+  do
+    kill -0 "${daemon_pid}" 2> /dev/null || return 1
+    sleep 0.1
+  done
+}
+
+# Stops the simulator service started by start_daemon, if it is running
+stop_daemon() {
+  if [[ -n "${daemon_pid-}" ]]
+  then
+    # (it removes its socket once its workers have stopped, and may linger as a zombie afterwards)
+    kill "${daemon_pid}" 2> /dev/null || true
+    while [[ -S "${work_dir}"/socket ]] && kill -0 "${daemon_pid}" 2> /dev/null
+    do
+      sleep 0.1
+    done
+    daemon_pid=""
+  fi
+}
+
 # Execute the simulator with the given schedule, writing output to the given output file
 # Parameters:
 #   $1 The schedule file to use
 #   $2 Where to write the output to
+#   $3 Where to write the simulator's summary of the results to (optional, and with limits, the resources it used are
+#      written to the same path with .resources added)
 # Returns 0 if the simulator completes successfully, or 1 if there is a failure
 process_schedule() {
   local schedule="${1}"
   local schedule_output="${2}"
+  local summary_options=()
+  local resources_options=()
+  local run=()
+
+  if [[ -n "${3-}" ]]
+  then
+    rm -f "${3}" "${3}".resources
+    summary_options=(--summary "${3}")
+    resources_options=(-r "${3}".resources)
+  fi
+  if "${limit}"
+  then
+    run=("${runner}" -t "${timeout}" -m "${memory}" "${resources_options[@]}" --)
+  fi
 
   if "${debug}"
   then
-    touch "${schedule_output}" && timeout "${timeout}" ./simulator -d "${schedule}" 2>&1 | tee "${schedule_output}" || return 1
+    touch "${schedule_output}" && timeout "${timeout}" "${run[@]}" ./simulator -d "${summary_options[@]}" "${schedule}" 2>&1 | tee "${schedule_output}" || return 1
   else
-    touch "${schedule_output}" && timeout "${timeout}" ./simulator "${schedule}" > "${schedule_output}" 2> /dev/null || return 1
+    touch "${schedule_output}" && timeout "${timeout}" "${run[@]}" ./simulator "${summary_options[@]}" "${schedule}" > "${schedule_output}" 2> /dev/null || return 1
   fi
   return 0
 }
 
-# Determines if the given schedule is different to any currently in $schedules
+# Prints a hash of the given schedule, ignoring line endings, blank lines and whitespace (and the order of the processes,
+# if $ignore_order), so schedules that the simulator reads in the same way have the same hash
 # Parameters:
-#   $1 The schedule to test
-# Returns 0 if no file in $schedules is identical to the one given in $1, or 1 if there is a matching schedule already
-unique_schedule() {
-  local test_schedule="${1}"
+#   $1 The schedule to hash
+schedule_hash() {
+  if "${ignore_order}"
+  then
+    tr -d '\r' < "${1}" | sed -e 's/[[:space:]]//g' -e '/^$/d' | { IFS= read -r header || true; echo "${header}"; LC_ALL=C sort; } | sha256sum | cut -d " " -f 1
+  else
+    tr -d '\r' < "${1}" | sed -e 's/[[:space:]]//g' -e '/^$/d' | sha256sum | cut -d " " -f 1
+  fi
+}
+
+# Loads the hashes of the schedules in $schedules into $schedule_hashes (mapping each hash to its schedule's name) from
+# the index file in $schedules, hashing any schedules that are missing from the index or have changed since it was
+# written, and rewrites the index with just the schedules that exist
+load_schedule_index() {
+  schedule_index="${schedules}"/.index
+  "${ignore_order}" && schedule_index="${schedule_index}_unordered"
+  declare -gA schedule_hashes=()
+  local -A indexed=()
 
+  if [[ -f "${schedule_index}" ]]
+  then
+    while read -r hash name
+    do
+      indexed["${name}"]="${hash}"
+    done < "${schedule_index}"
+  fi
+
+  local new_index="${schedule_index}.${BASHPID}"
+  : > "${new_index}"
   for existing_schedule in "${schedules}"/*
   do
-    if [[ -f "${existing_schedule}" ]]
+    [[ -f "${existing_schedule}" ]] || continue
+    local name=$(basename "${existing_schedule}")
+    local hash="${indexed[${name}]-}"
+    if [[ -z "${hash}" ]] || [[ "${existing_schedule}" -nt "${schedule_index}" ]]
     then
-      if diff -q "${existing_schedule}" "${test_schedule}" &> /dev/null
-      then
-        return 1
-      fi
+      hash=$(schedule_hash "${existing_schedule}")
     fi
+    schedule_hashes["${hash}"]="${name}"
+    echo "${hash} ${name}" >> "${new_index}"
   done
-  return 0
+  mv "${new_index}" "${schedule_index}"
 }
 
 # Collect the schedule file from the given submission, provided it is valid,
@@ -140,12 +306,15 @@ collect_schedule() {
 
     if process_schedule "${tmp_file}" "/dev/null"
     then
-      if unique_schedule "${tmp_file}"
+      local hash=$(schedule_hash "${tmp_file}")
+      if [[ -z "${schedule_hashes[${hash}]-}" ]]
       then
         cp "${tmp_file}" "${schedules}"/
+        schedule_hashes["${hash}"]=$(basename "${tmp_file}")
+        echo "${hash} $(basename "${tmp_file}")" >> "${schedule_index}"
         success "Valid spec_schedule.txt from $(basename "${submission}") copied to $(basename "${tmp_file}")"
       else
-        success "Valid spec_schedule.txt from $(basename "${submission}") (not unique)"
+        success "Valid spec_schedule.txt from $(basename "${submission}") (not unique, the same as ${schedule_hashes[${hash}]})"
       fi
     else
       warn "Invalid spec_schedule.txt from $(basename "${submission}")"
@@ -162,6 +331,7 @@ collect_schedules() {
   # only collect schedules if we have a valid fcfs implementation
   if setup_simulator "${solutions}" "fcfs"
   then
+    load_schedule_index
     if "${single}"
     then
       # collect the single submission, if only testing a single submission
@@ -179,7 +349,77 @@ collect_schedules() {
   teardown_simulator
 }
 
-# Processes the given algorithm from the given submission
+# Hashes the contents of every schedule in $schedules (with a single sha256sum) into $schedule_file_hashes, by name
+hash_schedules() {
+  declare -gA schedule_file_hashes=()
+  local hash file
+  while read -r hash file
+  do
+    schedule_file_hashes["${file##*/}"]="${hash}"
+  done < <(find "${schedules}" -mindepth 1 -maxdepth 1 -type f ! -name ".*" -exec sha256sum {} +)
+}
+
+# Finds the schedules whose output for the given submission and algorithm is stale, putting their names in
+# $stale_schedules. Each output is recorded in a manifest (output/.manifest/ALGORITHM/SUBMISSION) with a key made from
+# the hash of the simulator built with the algorithm, the hash of the schedule and the settings that affect the result,
+# and an output is stale if its key has changed (or it has no key, or with $force). The manifest is rewritten with just
+# the outputs that are up to date, so an output that is interrupted while being regenerated (or that fails, e.g. by timing
+# out) stays stale. The key for the
+# stale outputs is stored in $manifest_key, for record_outputs.
+# Parameters:
+#   $1 The directory containing the submission
+#   $2 The algorithm to process
+find_stale_schedules() {
+  local submission_output_dir="${output}"/"${2}"/$(basename "${1}")
+  manifest_file="${output}"/.manifest/"${2}"/$(basename "${1}")
+  manifest_key="$(simulator_hash "$(find "${1}" -name "${2}".c -type f | tail -n 1)")"
+  local settings="${timeout},${limit},${memory}"
+  local -A recorded=()
+  stale_schedules=()
+
+  if ! "${force}" && [[ -f "${manifest_file}" ]]
+  then
+    local key name
+    while read -r key name
+    do
+      recorded["${name}"]="${key}"
+    done < "${manifest_file}"
+  fi
+
+  mkdir -p "$(dirname "${manifest_file}")"
+  : > "${manifest_file}.${BASHPID}"
+  for schedule in "${schedules}"/*
+  do
+    local name="${schedule##*/}"
+    local key="${manifest_key}:${schedule_file_hashes[${name}]-none}:${settings}"
+    if [[ "${recorded[${name}]-}" == "${key}" ]] && [[ -f "${submission_output_dir}/${name}" ]]
+    then
+      echo "${key} ${name}" >> "${manifest_file}.${BASHPID}"
+    else
+      stale_schedules+=("${name}")
+    fi
+  done
+  mv "${manifest_file}.${BASHPID}" "${manifest_file}"
+  manifest_key="${manifest_key}:%s:${settings}"
+}
+
+# Records that the outputs for the given schedules are up to date in the manifest found by find_stale_schedules
+# Parameters:
+#   $1 The manifest file
+#   $2 The key of the outputs (with %s in place of the schedule's hash)
+#   $3... The names of the schedules
+record_outputs() {
+  local manifest_file="${1}"
+  local key="${2}"
+  shift 2
+
+  for name in "$@"
+  do
+    printf "${key} %s\n" "${schedule_file_hashes[${name}]-none}" "${name}"
+  done >> "${manifest_file}"
+}
+
+# Processes the given algorithm from the given submission, simulating just the schedules whose output is stale
 # Parameters:
 #   $1 The directory containing the submission
 #   $2 The algorithm to process
@@ -187,26 +427,35 @@ process_algorithm() {
   local submission="${1}"
   local algorithm="${2}"
   local submission_output_dir="${output}"/"${algorithm}"/$(basename "${submission}")
+  local submission_summary_dir="${output}"/.summary/"${algorithm}"/$(basename "${submission}")
 
   info "Processing $(basename "${submission}")"
-  # ensure directories/files exist
-  mkdir -p "${submission_output_dir}"
-  for schedule in "${schedules}"/*
-  do
-      touch "${submission_output_dir}"/$(basename "${schedule}")
-  done
+  find_stale_schedules "${submission}" "${algorithm}"
+  if [[ ${#stale_schedules[@]} -eq 0 ]]
+  then
+    info "\t${algorithm} is up to date"
+    msg ""
+    return 0
+  fi
+
+  # ensure directories/files exist (without the stale summaries)
+  mkdir -p "${submission_output_dir}" "${submission_summary_dir}"
+  local stale_summaries=("${stale_schedules[@]/#/${submission_summary_dir}/}")
+  touch "${stale_schedules[@]/#/${submission_output_dir}/}"
+  rm -f "${stale_summaries[@]}" "${stale_summaries[@]/%/.resources}"
 
-  # setup simulator and test all schedules
+  # setup simulator and test the stale schedules
   if setup_simulator "${submission}" "${algorithm}"
   then
     info "\tProcessing ${algorithm}"
-    for schedule in "${schedules}"/*
+    for name in "${stale_schedules[@]}"
     do
-      if process_schedule "${schedule}" "${submission_output_dir}"/$(basename "${schedule}")
+      if process_schedule "${schedules}/${name}" "${submission_output_dir}/${name}" "${submission_summary_dir}/${name}"
       then
-        success "Processed $(basename "${schedule}")"
+        success "Processed ${name}"
+        record_outputs "${manifest_file}" "${manifest_key}" "${name}"
       else
-        warn "Unable to process $(basename "${schedule}")"
+        warn "Unable to process ${name}"
       fi
     done
   else
@@ -216,6 +465,255 @@ process_algorithm() {
   msg ""
 }
 
+# Adds the given algorithm from the given submission to the tasks to process
+# Parameters:
+#   $1 The directory containing the submission
+#   $2 The algorithm to process
+add_task() {
+  task_submissions+=("${1}")
+  task_algorithms+=("${2}")
+}
+
+# Adds the given algorithm from each submission (or the single submission) to the tasks to process
+# Parameters:
+#   $1 The algorithm to process
+add_submission_tasks() {
+  local algorithm="${1}"
+
+  if "${single}"
+  then
+    add_task "${submissions}" "${algorithm}"
+  else
+    for submission in "${submissions}"/*
+    do
+      [[ -d "${submission}" ]] && add_task "${submission}" "${algorithm}"
+    done
+  fi
+  return 0
+}
+
+# Waits until fewer than $jobs workers are running in the background
+wait_for_worker() {
+  while [[ $(jobs -rp | wc -l) -ge "${jobs}" ]]
+  do
+    wait -n || true
+  done
+}
+
+# Runs a command as a background worker (which must not clean up after the main script), writing its messages to a log
+# Parameters:
+#   $1 The file to write the command's messages to
+#   $2... The command to run
+run_worker() {
+  local log="${1}"
+  shift
+
+  trap - SIGINT SIGTERM ERR EXIT
+  "$@" 2> "${log}"
+}
+
+# Builds a simulator with the given algorithm from the given submission in the given directory (for process_tasks)
+# Parameters:
+#   $1 The directory containing the submission
+#   $2 The algorithm to build
+#   $3 The directory to put the simulator in (it is left out if the build fails)
+build_task() {
+  if setup_simulator "${1}" "${2}"
+  then
+    mv simulator "${3}"/
+  fi
+  teardown_simulator
+}
+
+# Executes the simulator in the given directory with the given schedule (for process_tasks)
+# Parameters:
+#   $1 The schedule file to use
+#   $2 The directory containing the simulator
+#   $3 Where to write the output to
+#   $4 Where to write the simulator's summary of the results to
+#   $5 Where to write the status of the simulation to (0 if it completed successfully, 1 otherwise)
+simulate_task() {
+  cd "${2}"
+  if process_schedule "${1}" "${3}" "${4}"
+  then
+    success "Processed $(basename "${1}")"
+    echo 0 > "${5}"
+  else
+    warn "Unable to process $(basename "${1}")"
+    echo 1 > "${5}"
+  fi
+}
+
+# Simulates each stale schedule of each task (with a module) with the simulator service, using a single simulator_client
+# that runs up to $jobs at once, and writes the messages and status of each to the same files as simulate_task would (for
+# process_tasks)
+simulate_batch() {
+  local batch="${work_dir}"/batch
+  local names=()
+  local task_files=()
+  local results=()
+  : > "${batch}"
+
+  for ((i = 0; i < count; i++))
+  do
+    [[ -f "${task_binaries[i]}" ]] || continue
+    local submission_output_dir="${output}"/"${task_algorithms[i]}"/$(basename "${task_submissions[i]}")
+    local submission_summary_dir="${output}"/.summary/"${task_algorithms[i]}"/$(basename "${task_submissions[i]}")
+    local stale=()
+    mapfile -t stale < "${work_dir}/${i}/stale"
+    for ((k = 0; k < ${#stale[@]}; k++))
+    do
+      printf "task%s\t%s\t--summary\t%s\t%s\n" "${i}" "${submission_output_dir}/${stale[k]}" \
+        "${submission_summary_dir}/${stale[k]}" "${schedules}/${stale[k]}" >> "${batch}"
+      names+=("${stale[k]}")
+      task_files+=("${work_dir}/${i}/${k}")
+    done
+  done
+
+  mapfile -t results < <("${work_dir}"/simulator_client -j "${jobs}" -t "${timeout}" "${work_dir}"/socket < "${batch}")
+  for ((n = 0; n < ${#names[@]}; n++))
+  do
+    if [[ "${results[n]-1}" == "0" ]]
+    then
+      success "Processed ${names[n]}" 2> "${task_files[n]}.log"
+      echo 0 > "${task_files[n]}.status"
+    else
+      warn "Unable to process ${names[n]}" 2> "${task_files[n]}.log"
+      echo 1 > "${task_files[n]}.status"
+    fi
+  done
+}
+
+# Processes each algorithm and submission added with add_task. With more than one job (or with $daemon), the simulators
+# are built, then each (submission, algorithm, schedule) is simulated, by up to $jobs workers at once, and the results of
+# each are reported afterwards in the same order as when processing them one at a time. With $daemon, each algorithm is
+# built as a module (task${i}.so) instead, and simulated by a single batch of jobs sent to a simulator service that has
+# them all loaded
+process_tasks() {
+  local count=${#task_submissions[@]}
+  hash_schedules
+
+  if [[ "${jobs}" -le 1 ]] && ! "${daemon}"
+  then
+    for ((i = 0; i < count; i++))
+    do
+      process_algorithm "${task_submissions[i]}" "${task_algorithms[i]}"
+    done
+    return 0
+  fi
+
+  work_dir=$(mktemp -d)
+  local task_manifest_files=()
+  local task_manifest_keys=()
+  local task_binaries=()
+
+  # build a simulator for each task with stale outputs (ensuring its output directories/files exist, without the stale
+  # summaries), noting the stale schedules in its directory
+  for ((i = 0; i < count; i++))
+  do
+    mkdir -p "${work_dir}/${i}"
+    task_binaries[i]="${work_dir}/${i}/simulator"
+    "${daemon}" && task_binaries[i]="${work_dir}/${i}/task${i}.so"
+    find_stale_schedules "${task_submissions[i]}" "${task_algorithms[i]}"
+    task_manifest_files[i]="${manifest_file}"
+    task_manifest_keys[i]="${manifest_key}"
+    if [[ ${#stale_schedules[@]} -eq 0 ]]
+    then
+      touch "${work_dir}/${i}/up_to_date"
+      continue
+    fi
+    printf "%s\n" "${stale_schedules[@]}" > "${work_dir}/${i}/stale"
+
+    local submission_output_dir="${output}"/"${task_algorithms[i]}"/$(basename "${task_submissions[i]}")
+    local submission_summary_dir="${output}"/.summary/"${task_algorithms[i]}"/$(basename "${task_submissions[i]}")
+    mkdir -p "${submission_output_dir}" "${submission_summary_dir}"
+    local stale_summaries=("${stale_schedules[@]/#/${submission_summary_dir}/}")
+    touch "${stale_schedules[@]/#/${submission_output_dir}/}"
+    rm -f "${stale_summaries[@]}" "${stale_summaries[@]/%/.resources}"
+    wait_for_worker
+    if "${daemon}"
+    then
+      run_worker "${work_dir}/${i}/build.log" build_module "${task_submissions[i]}" "${task_algorithms[i]}" "${task_binaries[i]}" &
+    else
+      run_worker "${work_dir}/${i}/build.log" build_task "${task_submissions[i]}" "${task_algorithms[i]}" "${work_dir}/${i}" &
+    fi
+  done
+  wait
+
+  # start the simulator service with every module that was built
+  if "${daemon}"
+  then
+    local modules=()
+    for ((i = 0; i < count; i++))
+    do
+      [[ -f "${task_binaries[i]}" ]] && modules+=("${task_binaries[i]}")
+    done
+    if [[ ${#modules[@]} -gt 0 ]] && ! start_daemon "${modules[@]}"
+    then
+      cat "${work_dir}"/daemon.log >&2 || true
+      die "Unable to start the simulator service"
+    fi
+  fi
+
+  # simulate each stale schedule with each simulator that was built
+  for ((i = 0; i < count; i++))
+  do
+    [[ -f "${task_binaries[i]}" ]] && ! "${daemon}" || continue
+    local submission_output_dir="${output}"/"${task_algorithms[i]}"/$(basename "${task_submissions[i]}")
+    local submission_summary_dir="${output}"/.summary/"${task_algorithms[i]}"/$(basename "${task_submissions[i]}")
+    local stale=()
+    mapfile -t stale < "${work_dir}/${i}/stale"
+    for ((k = 0; k < ${#stale[@]}; k++))
+    do
+      wait_for_worker
+      run_worker "${work_dir}/${i}/${k}.log" simulate_task "${schedules}/${stale[k]}" "${work_dir}/${i}" \
+        "${submission_output_dir}/${stale[k]}" "${submission_summary_dir}/${stale[k]}" "${work_dir}/${i}/${k}.status" &
+    done
+  done
+  wait
+  if "${daemon}"
+  then
+    simulate_batch
+    stop_daemon
+  fi
+
+  # report the results of each task in order (recording the outputs that were regenerated successfully)
+  for ((i = 0; i < count; i++))
+  do
+    info "Processing $(basename "${task_submissions[i]}")"
+    if [[ -f "${work_dir}/${i}/up_to_date" ]]
+    then
+      info "\t${task_algorithms[i]} is up to date"
+    elif [[ -f "${task_binaries[i]}" ]]
+    then
+      info "\tProcessing ${task_algorithms[i]}"
+      local stale=()
+      local regenerated=()
+      mapfile -t stale < "${work_dir}/${i}/stale"
+      for ((k = 0; k < ${#stale[@]}; k++))
+      do
+        # (read with builtins, as there may be thousands of schedules)
+        local log=()
+        local status=1
+        mapfile -t log < "${work_dir}/${i}/${k}.log"
+        [[ ${#log[@]} -eq 0 ]] || printf "%s\n" "${log[@]}" >&2
+        [[ -f "${work_dir}/${i}/${k}.status" ]] && read -r status < "${work_dir}/${i}/${k}.status"
+        if [[ "${status}" == "0" ]]
+        then
+          regenerated+=("${stale[k]}")
+        fi
+      done
+      record_outputs "${task_manifest_files[i]}" "${task_manifest_keys[i]}" "${regenerated[@]}"
+    else
+      error "Unable to set up simulator with ${task_algorithms[i]} from $(basename "${task_submissions[i]}")"
+    fi
+    msg ""
+  done
+
+  rm -R "${work_dir}" || warn "Unable to remove ${work_dir}"
+  work_dir=""
+}
+
 # Calculate marks based on the number of schedules processed correctly
 # Parameters:
 #   $1 The directory containing the submission to mark
@@ -233,30 +731,6 @@ calculate_marks() {
   msg "\t$(basename "${submission}")\t${score}"
 }
 
-# Output the average turnaround time for the given submission and algorithm
-# Parameters:
-#   $1 The directory containing the submission to get averages for
-#   $2 The algorithm to get averages for
-#   $3 The file to store the average in
-output_averages () {
-  local submission="${1}"
-  local algorithm="${2}"
-  local competition_output="${3}"
-  local submission_output_dir="${output}"/"${algorithm}"/$(basename "${submission}")
-
-  for schedule in "${schedules}"/*
-  do
-    schedule_to_test="${submission_output_dir}"/$(basename "${schedule}")
-    local val="NULL"
-    if [[ -f "${schedule_to_test}" ]]
-    then
-      val=$((grep "Average turnaround time:" "${schedule_to_test}" | cut -f2) || echo "")
-    fi
-    [[ -z "${val}" ]] && val="NULL"
-    echo "$(basename "${submission}"),$(basename "${schedule}"),"${val}"" >> "${competition_output}"
-  done
-}
-
 # Print out configuration information
 print_configuration() {
   info "Configuration:"
@@ -267,9 +741,17 @@ print_configuration() {
   info "\tsolutions:   ${solutions}"
   info "\tsubmissions: ${submissions}"
   info "\tcollect:     ${collect}"
+  info "\tunordered:   ${ignore_order}"
   info "\tgenerate:    ${generate}"
   info "\tsingle:      ${single}"
   info "\ttimeout:     ${timeout}"
+  info "\tjobs:        ${jobs}"
+  info "\tbuild cache: ${build_cache:-none}"
+  info "\toptimise:    ${optimise}"
+  info "\tforce:       ${force}"
+  info "\tlimit:       ${limit}"
+  info "\tmemory:      ${memory}MB"
+  info "\tdaemon:      ${daemon}"
   info "\tmarks:       ${marks}"
   info "\tcompetition: ${competition}"
   info "\talgorithms:  ${args[*]}"
@@ -280,48 +762,40 @@ print_configuration() {
 main() {
   print_configuration
 
+  # Build the runner that limits the simulator's resources
+  if "${limit}"
+  then
+    setup_runner || die "Unable to build run_limited"
+  fi
+
   # Collect schedules
   if "${collect}"
   then
     collect_schedules
   fi
 
-  # Generate output for submissions
+  # Generate output for submissions (and the competition)
   if "${generate}"
   then
+    task_submissions=()
+    task_algorithms=()
     for algorithm in "${args[@]}"
     do
-      if "${single}"
-      then
-        process_algorithm "${submissions}" ${algorithm}
-      else
-        for submission in "${submissions}"/*
-        do
-          [[ -d "${submission}" ]] && process_algorithm "${submission}" ${algorithm}
-        done
-      fi
+      add_submission_tasks "${algorithm}"
 
       if "${generate_answers}"
       then
         # generate solution output, if possible
-        process_algorithm "${solutions}" ${algorithm}
+        add_task "${solutions}" "${algorithm}"
       fi
     done
-  fi
 
-  # Generate output for competition
-  if "${generate}" && [[ 0 -ne "${competition}" ]]
-  then
-    if "${single}"
+    if [[ 0 -ne "${competition}" ]]
     then
-      process_algorithm "${submissions}" "custom"
-    else
-      for submission in "${submissions}"/*
-      do
-        [[ -d "${submission}" ]] && process_algorithm "${submission}" "custom"
-      done
+      add_submission_tasks "custom"
     fi
- fi
+    process_tasks
+  fi
 
   # Output scores for algorithms
   if ! "${debug}" && [[ 0 -ne "${marks}" ]]
@@ -347,17 +821,29 @@ main() {
     msg ""
     info "Competition results:"
     competition_output="${output}"/"custom"/"competition_$(date -u "+%Y-%m-%d_%H-%M-%S").csv"
-    echo "Submission,Schedule,Average" > "${competition_output}"
+    local competitors=()
     if "${single}"
     then
-      output_averages "${submissions}" "custom" "${competition_output}"
+      competitors=("$(basename "${submissions}")")
     else
       for submission in "${submissions}"/*
       do
-        [[ -d "${submission}" ]] && output_averages "${submission}" "custom" "${competition_output}"
+        [[ -d "${submission}" ]] && competitors+=("$(basename "${submission}")")
       done
     fi
-    python3 score_competition.py "${competition_output}" "${competition}" | tee "${competition_output}"_results.txt
+    # (the averages are read from the simulator's summaries, all in one go, along with the resources each used
+    # with -r, so the scores can break ties on CPU time)
+    local fields=()
+    if "${limit}"
+    then
+      fields=(-f user_time_us -f system_time_us -f max_rss_kb -f voluntary_context_switches
+        -f involuntary_context_switches)
+    fi
+    python3 "${script_dir}"/aggregate_results.py "${fields[@]}" -o "${competition_output}" "${output}"/.summary/custom \
+      "${schedules}" "${competitors[@]}"
+    python3 "${script_dir}"/srpt_oracle.py -c "${competition_output}" "${schedules}" || warn "Unable to compute optimal averages"
+    python3 score_competition.py --by-schedule "${competition_output}"_schedules.csv \
+      --by-submission "${competition_output}"_submissions.csv "${competition_output}" "${competition}" | tee "${competition_output}"_results.txt
   fi
 }
 
@@ -367,6 +853,7 @@ parse_params() {
   simulator="simulator.c"
   schedules="schedules"
   collect=false
+  ignore_order=false
   solutions="algorithms"
   submissions="submissions"
   single=false
@@ -376,6 +863,14 @@ parse_params() {
   timeout="1m"
   marks=0
   competition=0
+  jobs=1
+  build_cache=""
+  default_build_cache=true
+  optimise=false
+  limit=false
+  memory=1024
+  force=false
+  daemon=false
 
   while :; do
     case "${1-}" in
@@ -387,6 +882,12 @@ parse_params() {
     -n | --no-generate) generate=false ;;
     -a | --generate-answers) generate_answers=true ;;
     -k | --collect) collect=true ;;
+    -i | --ignore-order) ignore_order=true ;;
+    -O | --optimise) optimise=true ;;
+    -r | --limit) limit=true ;;
+    -f | --force) force=true ;;
+    -D | --daemon) daemon=true ;;
+    --no-build-cache) build_cache="" default_build_cache=false ;;
     -s | --simulator)
       simulator="${2-}"
       shift
@@ -411,6 +912,19 @@ parse_params() {
       timeout="${2-}"
       shift
       ;;
+    -b | --build-cache)
+      build_cache="${2-}"
+      default_build_cache=false
+      shift
+      ;;
+    -j | --jobs)
+      jobs="${2-}"
+      shift
+      ;;
+    -M | --memory)
+      memory="${2-}"
+      shift
+      ;;
     -m | --marks)
       marks="${2-}"
       shift
@@ -439,6 +953,12 @@ parse_params() {
   solutions=$(realpath "${solutions}")
   submissions=$(realpath "${submissions}")
   output=$(realpath "${output}")
+  # the build cache defaults to being in the output directory (it is only created once something is added to it)
+  if "${default_build_cache}"
+  then
+    build_cache="${output}"/.build_cache
+  fi
+  [[ -z "${build_cache}" ]] || build_cache=$(realpath -m "${build_cache}")
 
   # ensure simulator is a regular file
   [[ -f "${simulator}" ]] || usage_die "simulator must be a regular tgz file (${simulator} is not)"
@@ -446,6 +966,23 @@ parse_params() {
   # ensure marks and competition are an integers
   [[ "${marks}" =~ ^[0-9]+$ ]] || usage_die "marks must be an integer (${marks} is not)"
   [[ "${competition}" =~ ^[0-9]+$ ]] || usage_die "competition must be an integer (${competition} is not)"
+  [[ "${jobs}" =~ ^[1-9][0-9]*$ ]] || usage_die "jobs must be a positive integer (${jobs} is not)"
+  [[ "${memory}" =~ ^[1-9][0-9]*$ ]] || usage_die "memory must be a positive integer (${memory} is not)"
+
+  # the simulator service's jobs are its own processes, so run_limited can't limit them
+  if "${daemon}" && "${limit}"
+  then
+    usage_die "The daemon can't be combined with limits"
+  fi
+
+  # debug output from several simulators at once would be interleaved (and is only seen if each simulator is run), and
+  # algorithms built as modules for the daemon never output debug messages
+  if "${debug}"
+  then
+    jobs=1
+    force=true
+    daemon=false
+  fi
 
   # ensure either competition or at least one algorithm are specified
   if [[ 0 -eq "${competition}" ]]
@@ -459,6 +996,15 @@ parse_params() {
 cleanup() {
   trap - SIGINT SIGTERM ERR EXIT
   teardown_simulator
+  stop_daemon
+  if ! [[ -z "${work_dir-}" ]] && [[ -d "${work_dir}" ]]
+  then
+    rm -R "${work_dir}" || warn "Unable to remove ${work_dir}"
+  fi
+  if ! [[ -z "${runner_dir-}" ]] && [[ -d "${runner_dir}" ]]
+  then
+    rm -R "${runner_dir}" || warn "Unable to remove ${runner_dir}"
+  fi
 }
 
 setup_colors() {
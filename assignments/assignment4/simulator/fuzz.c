@@ -0,0 +1,503 @@
+/*
+ * A differential fuzzer for scheduling algorithms.
+ * Generates random schedules rich in edge cases (identical arrivals, PIDs in reverse
+ * order, one-tick processes and huge gaps between arrivals), and simulates each with a
+ * candidate algorithm and a reference algorithm (both built as modules with module.c),
+ * reporting the first schedule where the processes they schedule differ.
+ * That schedule is then shrunk (removing processes and simplifying the rest for as long
+ * as the algorithms still differ) to a minimal schedule that reproduces the difference.
+ * Every simulation runs in this process: each module is reloaded before a simulation,
+ * so its global variables start from their initial values.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <dlfcn.h>
+
+// The interface the scheduling algorithms implement
+#include "scheduler.h"
+
+/* The largest process id supported by the simulator */
+#define MAX_PID 999999
+
+/* The number of schedules to generate by default */
+const unsigned long DEFAULT_ITERATIONS = 10000;
+
+/* The largest number of processes in a generated schedule by default */
+const unsigned int DEFAULT_MAX_PROCESSES = 12;
+
+/* The number of tickets a process has if none are given in the schedule */
+const unsigned int DEFAULT_TICKETS = 100;
+
+/* A scheduling algorithm built as a module, which can be reloaded to reset its state */
+typedef struct fuzz_module {
+  const char *path;  // the path the module is loaded from
+  void *handle;  // the handle of the loaded module
+  scheduler_module scheduler;  // the module's functions
+} fuzz_module;
+
+/* A schedule, with the processes in the order they appear in the file */
+typedef struct fuzz_schedule {
+  process_initial *processes;
+  unsigned int num_processes;
+} fuzz_schedule;
+
+/* Where (and how) two algorithms first differ on a schedule */
+typedef struct divergence {
+  bool diverged;  // whether the algorithms differ
+  unsigned int time;  // the time step they first differ at
+  unsigned int candidate_pid;  // the PID scheduled by the candidate at that time step
+  unsigned int reference_pid;  // the PID scheduled by the reference at that time step
+  const char *reason;  // a description of the difference
+} divergence;
+
+/* The state of the random number generator */
+unsigned long long rng_state = 240;
+
+/*
+ * Generates the next pseudo-random number using xorshift64*.
+ * returns:
+ *   A pseudo-random 64-bit number
+ */
+unsigned long long next_random() {
+  rng_state ^= rng_state >> 12;
+  rng_state ^= rng_state << 25;
+  rng_state ^= rng_state >> 27;
+  return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Generates a pseudo-random number in the given range.
+ * parameters:
+ *   low - the smallest number to generate
+ *   high - the largest number to generate
+ * returns:
+ *   A pseudo-random number from low to high (inclusive)
+ */
+unsigned int random_between(unsigned int low, unsigned int high) {
+  return low + next_random() % (high - low + 1);
+}
+
+/*
+ * (Re)loads the given module, so its global variables have their initial values.
+ * parameters:
+ *   module - the module to load (any previously loaded copy is unloaded first)
+ * returns:
+ *   TRUE if the module was loaded, FALSE otherwise (after printing an error message)
+ */
+bool load_module(fuzz_module *module) {
+  if (module->handle) {
+    dlclose(module->handle);
+    // If the module is still loaded (e.g., it can't be unloaded), its state would carry over
+    void *still_loaded = dlopen(module->path, RTLD_NOW | RTLD_LOCAL | RTLD_NOLOAD);
+    if (still_loaded) {
+      fprintf(stderr, "Module %s could not be unloaded to reset its state!\n", module->path);
+      dlclose(still_loaded);
+      module->handle = NULL;
+      return FALSE;
+    }
+  }
+  module->handle = dlopen(module->path, RTLD_NOW | RTLD_LOCAL);
+  if (!module->handle) {
+    fprintf(stderr, "Unable to load module %s: %s\n", module->path, dlerror());
+    return FALSE;
+  }
+  const scheduler_module *exported = dlsym(module->handle, SCHEDULER_MODULE_SYMBOL);
+  if (!exported) {
+    fprintf(stderr, "Module %s was not built with module.c!\n", module->path);
+    return FALSE;
+  }
+  module->scheduler = *exported;
+  return TRUE;
+}
+
+/*
+ * Determines the index of the process with the given PID.
+ * parameters:
+ *   schedule - the schedule to search
+ *   pid - the PID to search for
+ * returns:
+ *   The index of the process, or num_processes if there is no such process
+ */
+unsigned int find_process(const fuzz_schedule *schedule, unsigned int pid) {
+  unsigned int i = 0;
+  while (i < schedule->num_processes && schedule->processes[i].pid != pid) {
+    i++;
+  }
+  return i;
+}
+
+/*
+ * Determines whether any process other than the given one has the given PID.
+ * parameters:
+ *   schedule - the schedule to search
+ *   pid - the PID to search for
+ *   except - the index of the process to ignore
+ * returns:
+ *   TRUE if another process has the PID, FALSE otherwise
+ */
+bool pid_in_use(const fuzz_schedule *schedule, unsigned int pid, unsigned int except) {
+  for (unsigned int i = 0; i < schedule->num_processes; i++) {
+    if (i != except && schedule->processes[i].pid == pid) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/*
+ * Simulates the schedule with the candidate and reference algorithms in lockstep, in the same way as the
+ * simulator (processes arriving at the same time are added in the order they appear in the schedule), until
+ * they schedule different processes or both have finished.
+ * parameters:
+ *   candidate - the candidate algorithm
+ *   reference - the reference algorithm
+ *   schedule - the schedule to simulate
+ * returns:
+ *   Where the algorithms first differ (if they do)
+ */
+divergence compare_algorithms(fuzz_module *candidate, fuzz_module *reference, const fuzz_schedule *schedule) {
+  divergence result = {FALSE, 0, 0, 0, NULL};
+  unsigned int n = schedule->num_processes;
+  if (!load_module(candidate) || !load_module(reference)) {
+    exit(1);
+  }
+
+  // Sort the processes by arrival time (keeping the schedule's order for the same arrival time)
+  unsigned int order[n];
+  unsigned int processed[n];  // the processing time each process has had (the same for both, until they differ)
+  unsigned long time_bound = 1;
+  for (unsigned int i = 0; i < n; i++) {
+    unsigned int j = i;
+    while (j > 0 && schedule->processes[order[j - 1]].arrival_time > schedule->processes[i].arrival_time) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = i;
+    processed[i] = 0;
+    time_bound += schedule->processes[i].processing_time;
+  }
+  time_bound += schedule->processes[order[n - 1]].arrival_time;
+
+  // Simulate both, stopping at the first difference (a correct algorithm can't take longer than time_bound)
+  fuzz_module *modules[2] = {candidate, reference};
+  unsigned int remaining = n;
+  unsigned int next_arrival = 0;
+  for (unsigned int time = 0; time < time_bound && remaining > 0; time++) {
+    unsigned int arrivals_end = next_arrival;
+    while (arrivals_end < n && schedule->processes[order[arrivals_end]].arrival_time <= time) {
+      arrivals_end++;
+    }
+    unsigned int pids[2];
+    for (int m = 0; m < 2; m++) {
+      for (unsigned int i = next_arrival; i < arrivals_end; i++) {
+        modules[m]->scheduler.add_to_ready_queue(schedule->processes[order[i]]);
+      }
+      pids[m] = modules[m]->scheduler.get_next_scheduled_process();
+    }
+    next_arrival = arrivals_end;
+
+    result.time = time;
+    result.candidate_pid = pids[0];
+    result.reference_pid = pids[1];
+    if (pids[0] != pids[1]) {
+      result.diverged = TRUE;
+      result.reason = "the algorithms schedule different processes";
+      return result;
+    }
+    if (pids[0] > 0) {
+      unsigned int index = find_process(schedule, pids[0]);
+      if (index == n) {
+        result.diverged = TRUE;
+        result.reason = "both algorithms schedule a process that doesn't exist";
+        return result;
+      }
+      processed[index]++;
+      if (processed[index] == schedule->processes[index].processing_time) {
+        remaining--;
+      } else if (processed[index] > schedule->processes[index].processing_time) {
+        result.diverged = TRUE;
+        result.reason = "both algorithms schedule a process for longer than its processing time";
+        return result;
+      }
+    }
+  }
+  if (remaining > 0) {
+    result.diverged = TRUE;
+    result.reason = "the algorithms never finish";
+  }
+  return result;
+}
+
+/*
+ * Generates a random schedule, choosing at random which edge cases it contains.
+ * parameters:
+ *   schedule - where to store the schedule (with room for max_processes processes)
+ *   max_processes - the largest number of processes to generate
+ */
+void generate_schedule(fuzz_schedule *schedule, unsigned int max_processes) {
+  unsigned int n = random_between(1, max_processes);
+  unsigned int arrival_pattern = random_between(0, 3);
+  unsigned int pid_pattern = random_between(0, 2);
+  bool short_processes = random_between(0, 1);
+  bool extra_fields = random_between(0, 3) == 0;
+
+  unsigned int arrival_time = random_between(0, 1) ? 0 : random_between(0, 5);
+  for (unsigned int i = 0; i < n; i++) {
+    process_initial *process = &schedule->processes[i];
+    switch (arrival_pattern) {
+      case 0:  // every process arrives at the same time
+        break;
+      case 1:  // processes arrive at a few distinct times
+        arrival_time = random_between(0, 3);
+        break;
+      case 2:  // processes arrive close together (often at the same time)
+        arrival_time += random_between(0, 3);
+        break;
+      default:  // groups of processes separated by huge gaps
+        arrival_time += random_between(0, 3) == 0 ? random_between(1000, 100000) : random_between(0, 1);
+    }
+    process->arrival_time = arrival_time;
+    process->processing_time = short_processes && random_between(0, 1) ? 1 : random_between(1, 12);
+    process->tickets = extra_fields ? random_between(1, 200) : DEFAULT_TICKETS;
+    process->deadline = extra_fields && random_between(0, 1) ?
+        arrival_time + process->processing_time + random_between(0, 20) : NO_DEADLINE;
+  }
+
+  // Assign unique PIDs in increasing, decreasing or random order
+  for (unsigned int i = 0; i < n; i++) {
+    schedule->num_processes = i;  // only check the PIDs assigned so far
+    unsigned int pid;
+    if (pid_pattern == 0) {
+      pid = i + 1;
+    } else if (pid_pattern == 1) {
+      pid = n - i;
+    } else {
+      do {
+        pid = random_between(0, 1) ? random_between(1, 2 * n) : random_between(1, MAX_PID - 1);
+      } while (pid_in_use(schedule, pid, i));
+    }
+    schedule->processes[i].pid = pid;
+  }
+
+  // Sometimes shuffle the order the processes appear in the schedule
+  if (random_between(0, 1)) {
+    for (unsigned int i = n - 1; i > 0; i--) {
+      unsigned int j = random_between(0, i);
+      process_initial swap = schedule->processes[i];
+      schedule->processes[i] = schedule->processes[j];
+      schedule->processes[j] = swap;
+    }
+  }
+  schedule->num_processes = n;
+}
+
+/*
+ * Determines whether a changed schedule still makes the algorithms differ, keeping the change if so.
+ * parameters:
+ *   candidate - the candidate algorithm
+ *   reference - the reference algorithm
+ *   schedule - the schedule to shrink
+ *   changed - the changed schedule (with the same capacity), which replaces schedule if the algorithms differ
+ *   result - the current divergence, which is updated if the change is kept
+ * returns:
+ *   TRUE if the change was kept, FALSE otherwise
+ */
+bool try_change(fuzz_module *candidate, fuzz_module *reference, fuzz_schedule *schedule, fuzz_schedule *changed,
+    divergence *result) {
+  if (changed->num_processes == 0) {
+    return FALSE;
+  }
+  divergence changed_result = compare_algorithms(candidate, reference, changed);
+  if (!changed_result.diverged) {
+    return FALSE;
+  }
+  memcpy(schedule->processes, changed->processes, changed->num_processes * sizeof(process_initial));
+  schedule->num_processes = changed->num_processes;
+  *result = changed_result;
+  return TRUE;
+}
+
+/*
+ * Shrinks a schedule the algorithms differ on, for as long as they still differ: removing processes, then
+ * making each process arrive earlier, need less processing time and have a smaller PID, and dropping
+ * tickets and deadlines.
+ * parameters:
+ *   candidate - the candidate algorithm
+ *   reference - the reference algorithm
+ *   schedule - the schedule to shrink
+ *   result - where the algorithms differ, which is updated as the schedule shrinks
+ */
+void shrink_schedule(fuzz_module *candidate, fuzz_module *reference, fuzz_schedule *schedule, divergence *result) {
+  process_initial changed_processes[schedule->num_processes];
+  fuzz_schedule changed = {changed_processes, 0};
+  bool shrunk = TRUE;
+  while (shrunk) {
+    shrunk = FALSE;
+
+    // Try removing each process
+    for (unsigned int i = 0; i < schedule->num_processes; i++) {
+      changed.num_processes = 0;
+      for (unsigned int j = 0; j < schedule->num_processes; j++) {
+        if (j != i) {
+          changed.processes[changed.num_processes++] = schedule->processes[j];
+        }
+      }
+      if (try_change(candidate, reference, schedule, &changed, result)) {
+        shrunk = TRUE;
+        i--;
+      }
+    }
+
+    // Try simplifying each process, one field at a time
+    for (unsigned int i = 0; i < schedule->num_processes; i++) {
+      for (int field = 0; field < 7; field++) {
+        memcpy(changed.processes, schedule->processes, schedule->num_processes * sizeof(process_initial));
+        changed.num_processes = schedule->num_processes;
+        process_initial *process = &changed.processes[i];
+        unsigned int previous_arrival = 0;  // the latest arrival before this process's (to close gaps)
+        for (unsigned int j = 0; j < schedule->num_processes; j++) {
+          unsigned int other = schedule->processes[j].arrival_time;
+          if (other < process->arrival_time && other > previous_arrival) {
+            previous_arrival = other;
+          }
+        }
+        switch (field) {
+          case 0: process->arrival_time = 0; break;
+          case 1: process->arrival_time = previous_arrival; break;
+          case 2: process->arrival_time /= 2; break;
+          case 3: process->processing_time = 1; break;
+          case 4: process->processing_time = (process->processing_time + 1) / 2; break;
+          case 5: process->pid = process->pid > 1 ? process->pid / 2 : 1; break;
+          default: process->tickets = DEFAULT_TICKETS; process->deadline = NO_DEADLINE;
+        }
+        bool unchanged = memcmp(process, &schedule->processes[i], sizeof(process_initial)) == 0;
+        if (!unchanged && !pid_in_use(&changed, process->pid, i) && try_change(candidate, reference, schedule, &changed, result)) {
+          shrunk = TRUE;
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Writes a schedule out in the simulator's format.
+ * parameters:
+ *   fp - the file to write to
+ *   schedule - the schedule to write
+ */
+void write_schedule(FILE *fp, const fuzz_schedule *schedule) {
+  fprintf(fp, "%u\n", schedule->num_processes);
+  for (unsigned int i = 0; i < schedule->num_processes; i++) {
+    const process_initial *process = &schedule->processes[i];
+    fprintf(fp, "%u,%u,%u", process->pid, process->arrival_time, process->processing_time);
+    if (process->tickets != DEFAULT_TICKETS || process->deadline != NO_DEADLINE) {
+      fprintf(fp, ",%u", process->tickets);
+    }
+    if (process->deadline != NO_DEADLINE) {
+      fprintf(fp, ",%u", process->deadline);
+    }
+    fprintf(fp, "\n");
+  }
+}
+
+/*
+ * Prints out usage information for the program.
+ * parameters:
+ *   cmd - the command used to start the program
+ *   error - the error message that should be displayed (ignored if NULL)
+ */
+void usage(char *cmd, char *error) {
+  if (error) {
+    fprintf(stderr, "Error: %s\n\n", error);
+  }
+
+  fprintf(stderr, "Usage: %s [-n ITERATIONS] [-s SEED] [-p MAX_PROCESSES] [-o FILE] CANDIDATE REFERENCE\n", cmd);
+  fprintf(stderr, "Where:\n");
+  fprintf(stderr, "\t-n\tis the number of schedules to generate (defaults to %lu)\n", DEFAULT_ITERATIONS);
+  fprintf(stderr, "\t-s\tis the seed for the random number generator (defaults to 240)\n");
+  fprintf(stderr, "\t-p\tis the largest number of processes in a schedule (defaults to %u)\n", DEFAULT_MAX_PROCESSES);
+  fprintf(stderr, "\t-o\tis the file to write a schedule the algorithms differ on to (defaults to standard output)\n");
+  fprintf(stderr, "\tCANDIDATE\tis the algorithm to test, built as a module with module.c\n");
+  fprintf(stderr, "\tREFERENCE\tis the algorithm it should match, built as a module with module.c\n");
+}
+
+/*
+ *  Program entry point.
+ *  Compares the algorithms on random schedules until they differ, then shrinks and outputs that schedule.
+ *  Exits with status 1 if the algorithms differ.
+ */
+int main(int argc, char *argv[]) {
+  // Check arguments
+  unsigned long iterations = DEFAULT_ITERATIONS;
+  unsigned int max_processes = DEFAULT_MAX_PROCESSES;
+  char *output = NULL;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:p:o:")) != -1) {
+    switch (opt) {
+      case 'n':
+        iterations = strtoul(optarg, NULL, 10);
+        break;
+      case 's':
+        rng_state = strtoull(optarg, NULL, 10);
+        break;
+      case 'p':
+        max_processes = strtoul(optarg, NULL, 10);
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      default:
+        usage(argv[0], "Invalid command line arguments");
+        return -1;
+    }
+  }
+  if (argc - optind != 2 || max_processes < 1 || max_processes > 10000 || rng_state == 0) {
+    usage(argv[0], "Invalid command line arguments");
+    return -1;
+  }
+
+  // Load modules from the current directory (rather than the library path) if no directory is given
+  char paths[2][PATH_MAX];
+  fuzz_module modules[2];
+  for (int m = 0; m < 2; m++) {
+    const char *path = argv[optind + m];
+    snprintf(paths[m], sizeof(paths[m]), "%s%s", strchr(path, '/') ? "" : "./", path);
+    modules[m].path = paths[m];
+    modules[m].handle = NULL;
+  }
+  if (strcmp(paths[0], paths[1]) == 0) {
+    usage(argv[0], "The candidate and reference must be different modules");
+    return -1;
+  }
+
+  process_initial processes[max_processes];
+  fuzz_schedule schedule = {processes, 0};
+  for (unsigned long i = 0; i < iterations; i++) {
+    generate_schedule(&schedule, max_processes);
+    divergence result = compare_algorithms(&modules[0], &modules[1], &schedule);
+    if (result.diverged) {
+      unsigned int original_size = schedule.num_processes;
+      shrink_schedule(&modules[0], &modules[1], &schedule, &result);
+      fprintf(stderr, "Schedule %lu: %s at time %u (candidate scheduled %u, reference scheduled %u)\n", i + 1,
+          result.reason, result.time, result.candidate_pid, result.reference_pid);
+      fprintf(stderr, "Shrunk from %u to %u processes:\n", original_size, schedule.num_processes);
+      FILE *fp = output ? fopen(output, "w") : stdout;
+      if (!fp) {
+        perror("Unable to write schedule");
+        return 1;
+      }
+      write_schedule(fp, &schedule);
+      if (output) {
+        fclose(fp);
+        fprintf(stderr, "Written to %s\n", output);
+      }
+      return 1;
+    }
+  }
+  fprintf(stderr, "The algorithms matched on all %lu schedules\n", iterations);
+  return 0;
+}
@@ -0,0 +1,342 @@
+/*
+ * A generator of synthetic schedule files.
+ * Arrivals follow a Poisson process, or a two-state Markov-modulated Poisson process
+ * (MMPP) that alternates between a normal and a bursty arrival rate.
+ * Processing times are drawn from an exponential, Pareto (heavy-tailed) or bimodal
+ * distribution. The same seed always generates the same schedule.
+ * Processes are written as they are generated, so schedules of any size can be
+ * generated in constant memory.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+
+/* The largest processing time generated by default (the largest the simulator accepts) */
+#define DEFAULT_MAX_PROCESSING_TIME 999999
+
+/* The simulator's limit on PIDs, arrival times, processing times and the number of processes */
+#define SIMULATOR_LIMIT 1000000
+
+/* The arrival processes supported */
+typedef enum arrival_process {
+  POISSON,
+  MMPP
+} arrival_process;
+
+/* The processing time distributions supported */
+typedef enum processing_distribution {
+  EXPONENTIAL,
+  PARETO,
+  BIMODAL
+} processing_distribution;
+
+/* The parameters of the schedule to generate */
+typedef struct generator_options {
+  unsigned long num_processes;  // the number of processes to generate
+  unsigned long long seed;  // the seed for the random number generator
+  arrival_process arrivals;  // how arrival times are generated
+  double rate;  // the mean number of arrivals per time unit (in the normal state, for MMPP)
+  double burst_rate;  // the mean number of arrivals per time unit in the bursty state (MMPP only)
+  double normal_length;  // the mean time spent in the normal state before a burst (MMPP only)
+  double burst_length;  // the mean time a burst lasts (MMPP only)
+  processing_distribution distribution;  // how processing times are generated
+  double mean;  // the mean processing time (exponential and Pareto)
+  double alpha;  // the shape of the Pareto distribution (smaller is heavier-tailed, must be > 1)
+  double short_mean;  // the mean processing time of short processes (bimodal only)
+  double long_mean;  // the mean processing time of long processes (bimodal only)
+  double long_fraction;  // the fraction of processes that are long (bimodal only)
+  unsigned long max_processing_time;  // the largest processing time to generate
+} generator_options;
+
+/* The state of the random number generator */
+unsigned long long rng_state;
+
+/*
+ * Generates the next pseudo-random number using xorshift64*.
+ * returns:
+ *   A pseudo-random 64-bit number
+ */
+unsigned long long next_random() {
+  rng_state ^= rng_state >> 12;
+  rng_state ^= rng_state << 25;
+  rng_state ^= rng_state >> 27;
+  return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Generates a pseudo-random number uniformly distributed in (0, 1].
+ * returns:
+ *   A pseudo-random number greater than 0 and at most 1
+ */
+double uniform() {
+  return ((next_random() >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * Generates a pseudo-random number from an exponential distribution.
+ * parameters:
+ *   mean - the mean of the distribution
+ * returns:
+ *   A pseudo-random number from the distribution
+ */
+double exponential(double mean) {
+  return -mean * log(uniform());
+}
+
+/*
+ * Generates a pseudo-random number from a Pareto distribution.
+ * parameters:
+ *   mean - the mean of the distribution
+ *   alpha - the shape of the distribution (must be greater than 1)
+ * returns:
+ *   A pseudo-random number from the distribution
+ */
+double pareto(double mean, double alpha) {
+  double scale = mean * (alpha - 1) / alpha;
+  return scale / pow(uniform(), 1 / alpha);
+}
+
+/*
+ * Generates the processing time of the next process.
+ * parameters:
+ *   options - the parameters of the schedule being generated
+ * returns:
+ *   A processing time between 1 and the maximum processing time
+ */
+unsigned long next_processing_time(const generator_options *options) {
+  double time;
+  switch (options->distribution) {
+    case PARETO:
+      time = pareto(options->mean, options->alpha);
+      break;
+    case BIMODAL:
+      time = exponential(uniform() <= options->long_fraction ? options->long_mean : options->short_mean);
+      break;
+    default:
+      time = exponential(options->mean);
+  }
+  if (time < 1) {
+    return 1;
+  }
+  if (time >= options->max_processing_time) {
+    return options->max_processing_time;
+  }
+  return (unsigned long) ceil(time);
+}
+
+/*
+ * Writes the given number followed by the given separator to the given buffer.
+ * parameters:
+ *   buffer - where to write the number (must have room for 21 characters)
+ *   value - the number to write
+ *   separator - the character to write after the number
+ * returns:
+ *   The position in buffer after the separator
+ */
+char *write_number(char *buffer, unsigned long value, char separator) {
+  char digits[20];
+  int count = 0;
+  do {
+    digits[count++] = '0' + value % 10;
+    value /= 10;
+  } while (value > 0);
+  while (count > 0) {
+    *buffer++ = digits[--count];
+  }
+  *buffer++ = separator;
+  return buffer;
+}
+
+/*
+ * Generates a schedule, writing it to the given file.
+ * parameters:
+ *   options - the parameters of the schedule to generate
+ *   out - the file to write the schedule to
+ * returns:
+ *   The largest arrival time or processing time generated (to check against the simulator's limits)
+ */
+unsigned long generate(const generator_options *options, FILE *out) {
+  char line[64];
+  char *end = write_number(line, options->num_processes, '\n');
+  fwrite(line, 1, end - line, out);
+
+  rng_state = options->seed ? options->seed : 1;
+  double time = 0;
+  int bursting = 0;
+  double state_change = options->arrivals == MMPP ? exponential(options->normal_length) : INFINITY;
+  unsigned long largest = 0;
+  for (unsigned long pid = 1; pid <= options->num_processes; pid++) {
+    // Advance to the next arrival, moving between the normal and bursty states as their time runs out
+    double next_arrival = time + exponential(1 / (bursting ? options->burst_rate : options->rate));
+    while (next_arrival > state_change) {
+      time = state_change;
+      bursting = !bursting;
+      state_change = time + exponential(bursting ? options->burst_length : options->normal_length);
+      next_arrival = time + exponential(1 / (bursting ? options->burst_rate : options->rate));
+    }
+    time = next_arrival;
+
+    unsigned long processing_time = next_processing_time(options);
+    if ((unsigned long) time > largest) {
+      largest = (unsigned long) time;
+    }
+    if (processing_time > largest) {
+      largest = processing_time;
+    }
+    end = write_number(line, pid, ',');
+    end = write_number(end, (unsigned long) time, ',');
+    end = write_number(end, processing_time, '\n');
+    fwrite(line, 1, end - line, out);
+  }
+  return largest;
+}
+
+/*
+ * Prints out usage information for the program.
+ * parameters:
+ *   cmd - the command used to start the program
+ *   error - the error message that should be displayed (ignored if NULL)
+ */
+void usage(char *cmd, char *error) {
+  if (error) {
+    fprintf(stderr, "Error: %s\n\n", error);
+  }
+
+  fprintf(stderr, "Usage: %s -n NUM_PROCESSES [options]\n", cmd);
+  fprintf(stderr, "Where the options are:\n");
+  fprintf(stderr, "\t-n, --processes N\tthe number of processes to generate\n");
+  fprintf(stderr, "\t-s, --seed N\t\tthe seed for the random number generator (defaults to 240)\n");
+  fprintf(stderr, "\t-o, --output FILE\tthe file to write the schedule to (defaults to standard output)\n");
+  fprintf(stderr, "\t-a, --arrivals TYPE\thow arrivals are generated: poisson (default) or mmpp\n");
+  fprintf(stderr, "\t-r, --rate R\t\tthe mean arrivals per time unit (defaults to 0.1)\n");
+  fprintf(stderr, "\t--burst-rate R\t\tthe mean arrivals per time unit during a burst (mmpp only, defaults to 10 x rate)\n");
+  fprintf(stderr, "\t--normal-length T\tthe mean time between bursts (mmpp only, defaults to 1000)\n");
+  fprintf(stderr, "\t--burst-length T\tthe mean time a burst lasts (mmpp only, defaults to 100)\n");
+  fprintf(stderr, "\t-b, --bursts TYPE\thow processing times are generated: exponential (default), pareto or bimodal\n");
+  fprintf(stderr, "\t-m, --mean T\t\tthe mean processing time (exponential and pareto, defaults to 8)\n");
+  fprintf(stderr, "\t--alpha A\t\tthe shape of the Pareto distribution, greater than 1 (defaults to 1.5)\n");
+  fprintf(stderr, "\t--short-mean T\t\tthe mean processing time of short processes (bimodal only, defaults to 2)\n");
+  fprintf(stderr, "\t--long-mean T\t\tthe mean processing time of long processes (bimodal only, defaults to 100)\n");
+  fprintf(stderr, "\t--long-fraction P\tthe fraction of processes that are long (bimodal only, defaults to 0.1)\n");
+  fprintf(stderr, "\t--max-time T\t\tthe largest processing time to generate (defaults to %d)\n", DEFAULT_MAX_PROCESSING_TIME);
+}
+
+/*
+ *  Program entry point.
+ *  Reads the options describing the schedule and generates it.
+ */
+int main(int argc, char *argv[]) {
+  generator_options options = {0, 240, POISSON, 0.1, 0, 1000, 100, EXPONENTIAL, 8, 1.5, 2, 100, 0.1, DEFAULT_MAX_PROCESSING_TIME};
+  char *filename = NULL;
+
+  static struct option long_options[] = {
+    {"processes", required_argument, NULL, 'n'},
+    {"seed", required_argument, NULL, 's'},
+    {"output", required_argument, NULL, 'o'},
+    {"arrivals", required_argument, NULL, 'a'},
+    {"rate", required_argument, NULL, 'r'},
+    {"burst-rate", required_argument, NULL, 'R'},
+    {"normal-length", required_argument, NULL, 'N'},
+    {"burst-length", required_argument, NULL, 'B'},
+    {"bursts", required_argument, NULL, 'b'},
+    {"mean", required_argument, NULL, 'm'},
+    {"alpha", required_argument, NULL, 'A'},
+    {"short-mean", required_argument, NULL, 'S'},
+    {"long-mean", required_argument, NULL, 'L'},
+    {"long-fraction", required_argument, NULL, 'P'},
+    {"max-time", required_argument, NULL, 'M'},
+    {NULL, 0, NULL, 0}
+  };
+  int opt;
+  while ((opt = getopt_long(argc, argv, "n:s:o:a:r:b:m:", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'n': options.num_processes = strtoul(optarg, NULL, 10); break;
+      case 's': options.seed = strtoull(optarg, NULL, 10); break;
+      case 'o': filename = optarg; break;
+      case 'r': options.rate = atof(optarg); break;
+      case 'R': options.burst_rate = atof(optarg); break;
+      case 'N': options.normal_length = atof(optarg); break;
+      case 'B': options.burst_length = atof(optarg); break;
+      case 'm': options.mean = atof(optarg); break;
+      case 'A': options.alpha = atof(optarg); break;
+      case 'S': options.short_mean = atof(optarg); break;
+      case 'L': options.long_mean = atof(optarg); break;
+      case 'P': options.long_fraction = atof(optarg); break;
+      case 'M': options.max_processing_time = strtoul(optarg, NULL, 10); break;
+      case 'a':
+        if (strcmp(optarg, "poisson") == 0) {
+          options.arrivals = POISSON;
+        } else if (strcmp(optarg, "mmpp") == 0) {
+          options.arrivals = MMPP;
+        } else {
+          usage(argv[0], "Unknown arrival process");
+          return -1;
+        }
+        break;
+      case 'b':
+        if (strcmp(optarg, "exponential") == 0) {
+          options.distribution = EXPONENTIAL;
+        } else if (strcmp(optarg, "pareto") == 0) {
+          options.distribution = PARETO;
+        } else if (strcmp(optarg, "bimodal") == 0) {
+          options.distribution = BIMODAL;
+        } else {
+          usage(argv[0], "Unknown processing time distribution");
+          return -1;
+        }
+        break;
+      default:
+        usage(argv[0], "Invalid command line arguments");
+        return -1;
+    }
+  }
+  if (options.burst_rate <= 0) {
+    options.burst_rate = 10 * options.rate;
+  }
+
+  // Check the options describe a valid schedule
+  if (optind != argc || options.num_processes < 1) {
+    usage(argv[0], "The number of processes must be given, and be at least 1");
+    return -1;
+  }
+  if (options.rate <= 0 || options.normal_length <= 0 || options.burst_length <= 0) {
+    usage(argv[0], "Rates and lengths must be positive");
+    return -1;
+  }
+  if (options.mean <= 0 || options.short_mean <= 0 || options.long_mean <= 0 || options.max_processing_time < 1) {
+    usage(argv[0], "Processing times must be positive");
+    return -1;
+  }
+  if (options.alpha <= 1) {
+    usage(argv[0], "The Pareto shape (alpha) must be greater than 1");
+    return -1;
+  }
+  if (options.long_fraction < 0 || options.long_fraction > 1) {
+    usage(argv[0], "The fraction of long processes must be between 0 and 1");
+    return -1;
+  }
+
+  FILE *out = stdout;
+  if (filename) {
+    out = fopen(filename, "w");
+    if (!out) {
+      fprintf(stderr, "Unable to write %s!\n", filename);
+      return 1;
+    }
+  }
+  setvbuf(out, NULL, _IOFBF, 1 << 20);
+
+  unsigned long largest = generate(&options, out);
+  if (fclose(out) != 0) {
+    fprintf(stderr, "Unable to write schedule!\n");
+    return 1;
+  }
+  if (options.num_processes >= SIMULATOR_LIMIT || largest >= SIMULATOR_LIMIT) {
+    fprintf(stderr, "Warning: the schedule exceeds the simulator's limits (fewer than 1,000,000 processes, PIDs and "
+        "times), simulate it with --stream or use fewer processes or a higher rate\n");
+  }
+  return 0;
+}
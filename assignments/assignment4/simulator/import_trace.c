@@ -0,0 +1,593 @@
+/*
+ * A converter from Linux scheduler traces to schedule files.
+ * Reads the text output of `perf sched script` (or `perf script` with the sched tracepoints)
+ * or an ftrace dump with the sched_switch and sched_wakeup events, and turns each CPU burst
+ * of each task into a process: the burst arrives when the task wakes up (or is first seen
+ * runnable) and its processing time is the CPU time the task used until it next blocked.
+ * Being preempted doesn't end a burst. Bursts are numbered in the order they arrive.
+ * The trace is read a line at a time and each burst is written as soon as it ends, so
+ * traces of any size can be converted; only the tasks themselves are kept in memory.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+
+/* The length of a time unit by default, in nanoseconds (1ms) */
+#define DEFAULT_TICK 1000000
+
+/* The width of the number of processes at the start of the schedule, which is only known once the trace is read */
+#define COUNT_WIDTH 10
+
+/* The simulator's limit on PIDs, arrival times, processing times and the number of processes */
+#define SIMULATOR_LIMIT 1000000
+
+/* The number of tasks the task table starts with room for (must be a power of 2) */
+#define INITIAL_TASKS 1024
+
+/* A task seen in the trace, and its current CPU burst */
+typedef struct trace_task {
+  unsigned long pid;  // the kernel's PID of the task (0 if this slot of the table is unused)
+  int in_burst;  // whether the task is runnable (its burst has arrived but not ended)
+  int running;  // whether the task is on a CPU
+  unsigned long long arrival;  // when the current burst arrived (ns)
+  unsigned long long run_start;  // when the task last started running (ns)
+  unsigned long long processed;  // the CPU time used by the current burst, before run_start (ns)
+  unsigned long schedule_pid;  // the PID of the current burst in the schedule
+} trace_task;
+
+/* The tasks seen in the trace, in an open addressing hash table */
+typedef struct task_table {
+  trace_task *tasks;
+  unsigned long capacity;  // always a power of 2
+  unsigned long count;
+} task_table;
+
+/* The state of a conversion */
+typedef struct converter {
+  task_table table;
+  FILE *out;  // where the schedule is written
+  unsigned long long tick;  // the length of a time unit (ns)
+  unsigned long long start;  // the time of the first event in the trace (ns)
+  unsigned long long last;  // the time of the latest event in the trace (ns)
+  int started;  // whether an event has been seen yet
+  unsigned long next_pid;  // the PID of the next burst to arrive
+  unsigned long written;  // the number of bursts written
+  unsigned long events;  // the number of events read
+  unsigned long skipped;  // the number of events that couldn't be parsed
+  unsigned long long largest_arrival;  // the latest arrival written (in time units)
+  unsigned long long largest_processing;  // the largest processing time written (in time units)
+} converter;
+
+/*
+ * Finds the given task in the table, adding it if it's not there.
+ * parameters:
+ *   table - the table of tasks
+ *   pid - the kernel's PID of the task (not 0)
+ * returns:
+ *   The task, or NULL if the table is full and can't be grown
+ */
+trace_task *find_task(task_table *table, unsigned long pid) {
+  if (2 * (table->count + 1) > table->capacity) {
+    // Grow the table, re-inserting every task
+    unsigned long capacity = table->capacity ? 2 * table->capacity : INITIAL_TASKS;
+    trace_task *tasks = calloc(capacity, sizeof(trace_task));
+    if (!tasks) {
+      return NULL;
+    }
+    for (unsigned long i = 0; i < table->capacity; i++) {
+      if (table->tasks[i].pid) {
+        unsigned long slot = (table->tasks[i].pid * 0x9E3779B97F4A7C15ULL) & (capacity - 1);
+        while (tasks[slot].pid) {
+          slot = (slot + 1) & (capacity - 1);
+        }
+        tasks[slot] = table->tasks[i];
+      }
+    }
+    free(table->tasks);
+    table->tasks = tasks;
+    table->capacity = capacity;
+  }
+
+  unsigned long slot = (pid * 0x9E3779B97F4A7C15ULL) & (table->capacity - 1);
+  while (table->tasks[slot].pid && table->tasks[slot].pid != pid) {
+    slot = (slot + 1) & (table->capacity - 1);
+  }
+  if (!table->tasks[slot].pid) {
+    table->tasks[slot].pid = pid;
+    table->count++;
+  }
+  return &table->tasks[slot];
+}
+
+/*
+ * Starts a new CPU burst of a task, if it doesn't already have one.
+ * parameters:
+ *   conv - the conversion
+ *   task - the task that has become runnable
+ *   time - when it became runnable (ns)
+ */
+void start_burst(converter *conv, trace_task *task, unsigned long long time) {
+  if (!task->in_burst) {
+    task->in_burst = 1;
+    task->arrival = time;
+    task->processed = 0;
+    task->schedule_pid = conv->next_pid++;
+  }
+}
+
+/*
+ * Writes the given number followed by the given separator to the given buffer.
+ * parameters:
+ *   buffer - where to write the number (must have room for 21 characters)
+ *   value - the number to write
+ *   separator - the character to write after the number
+ * returns:
+ *   The position in buffer after the separator
+ */
+char *write_number(char *buffer, unsigned long long value, char separator) {
+  char digits[20];
+  int count = 0;
+  do {
+    digits[count++] = '0' + value % 10;
+    value /= 10;
+  } while (value > 0);
+  while (count > 0) {
+    *buffer++ = digits[--count];
+  }
+  *buffer++ = separator;
+  return buffer;
+}
+
+/*
+ * Ends a task's current CPU burst, writing it to the schedule as a process (if it used any CPU time).
+ * Times are converted to time units, with processing times rounded to the nearest unit (but at least 1).
+ * parameters:
+ *   conv - the conversion
+ *   task - the task whose burst has ended (which must not be running)
+ */
+void end_burst(converter *conv, trace_task *task) {
+  task->in_burst = 0;
+  if (task->processed == 0) {
+    return;
+  }
+  unsigned long long arrival = (task->arrival - conv->start) / conv->tick;
+  unsigned long long processing = (task->processed + conv->tick / 2) / conv->tick;
+  if (processing == 0) {
+    processing = 1;
+  }
+  if (arrival > conv->largest_arrival) {
+    conv->largest_arrival = arrival;
+  }
+  if (processing > conv->largest_processing) {
+    conv->largest_processing = processing;
+  }
+
+  char line[64];
+  char *end = write_number(line, task->schedule_pid, ',');
+  end = write_number(end, arrival, ',');
+  end = write_number(end, processing, '\n');
+  fwrite(line, 1, end - line, conv->out);
+  conv->written++;
+}
+
+/*
+ * Adds the time a task has been running for to its current burst, if it is running.
+ * parameters:
+ *   task - the task that has stopped running
+ *   time - when it stopped running (ns)
+ */
+void stop_running(trace_task *task, unsigned long long time) {
+  if (task->running) {
+    task->running = 0;
+    task->processed += time - task->run_start;
+  }
+}
+
+/*
+ * Records that a task has stopped running.
+ * parameters:
+ *   conv - the conversion
+ *   pid - the kernel's PID of the task (ignored if 0, the idle task)
+ *   runnable - whether the task is still runnable (it was preempted, rather than blocking or exiting)
+ *   time - when it stopped running (ns)
+ * returns:
+ *   0 if successful, -1 if the task table couldn't be grown
+ */
+int switch_out(converter *conv, unsigned long pid, int runnable, unsigned long long time) {
+  if (pid == 0) {
+    return 0;
+  }
+  trace_task *task = find_task(&conv->table, pid);
+  if (!task) {
+    return -1;
+  }
+  stop_running(task, time);
+  if (runnable) {
+    // A task running since before the trace started only has the rest of its burst in the trace
+    start_burst(conv, task, time);
+  } else if (task->in_burst) {
+    end_burst(conv, task);
+  }
+  return 0;
+}
+
+/*
+ * Records that a task has started running (or has become runnable, if it isn't running).
+ * parameters:
+ *   conv - the conversion
+ *   pid - the kernel's PID of the task (ignored if 0, the idle task)
+ *   running - whether the task is now on a CPU
+ *   time - when it started running, or became runnable (ns)
+ * returns:
+ *   0 if successful, -1 if the task table couldn't be grown
+ */
+int switch_in(converter *conv, unsigned long pid, int running, unsigned long long time) {
+  if (pid == 0) {
+    return 0;
+  }
+  trace_task *task = find_task(&conv->table, pid);
+  if (!task) {
+    return -1;
+  }
+  start_burst(conv, task, time);
+  if (running && !task->running) {
+    task->running = 1;
+    task->run_start = time;
+  }
+  return 0;
+}
+
+/*
+ * Parses the timestamp before an event's name, which both perf and ftrace write as SECONDS.FRACTION: (perf
+ * also puts the tracepoint's subsystem before the name).
+ * parameters:
+ *   line - the start of the line
+ *   event - the start of the event's name in the line
+ *   time - where to store the timestamp (ns)
+ * returns:
+ *   1 if there is a timestamp, 0 otherwise
+ */
+int parse_timestamp(const char *line, const char *event, unsigned long long *time) {
+  const char *end = event;
+  if (end - line >= 6 && strncmp(end - 6, "sched:", 6) == 0) {
+    end -= 6;
+  }
+  while (end > line && end[-1] == ' ') {
+    end--;
+  }
+  if (end == line || end[-1] != ':') {
+    return 0;
+  }
+  end--;
+  const char *start = end;
+  while (start > line && ((start[-1] >= '0' && start[-1] <= '9') || start[-1] == '.')) {
+    start--;
+  }
+
+  unsigned long long seconds = 0;
+  unsigned long long fraction = 0;
+  int fraction_digits = -1;  // -1 until the decimal point
+  for (const char *c = start; c < end; c++) {
+    if (*c == '.') {
+      if (fraction_digits >= 0) {
+        return 0;
+      }
+      fraction_digits = 0;
+    } else if (fraction_digits < 0) {
+      seconds = 10 * seconds + (*c - '0');
+    } else if (fraction_digits < 9) {
+      fraction = 10 * fraction + (*c - '0');
+      fraction_digits++;
+    }
+  }
+  if (fraction_digits <= 0) {
+    return 0;
+  }
+  while (fraction_digits++ < 9) {
+    fraction *= 10;
+  }
+  *time = seconds * 1000000000ULL + fraction;
+  return 1;
+}
+
+/*
+ * Parses the number after the given key (e.g., " prev_pid=") in part of a line.
+ * parameters:
+ *   start - the start of the part of the line to search
+ *   end - the end of the part of the line to search
+ *   key - the key to search for, including the space before it and the = after it
+ *   value - where to store the number
+ * returns:
+ *   A pointer to the first character after the key's value, or NULL if there is no such key
+ */
+const char *parse_key(const char *start, const char *end, const char *key, unsigned long *value) {
+  size_t length = strlen(key);
+  for (const char *c = start; c + length <= end; c++) {
+    if (*c == *key && strncmp(c, key, length) == 0) {
+      c += length;
+      *value = strtoul(c, (char **) &c, 10);
+      return c;
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Parses the PID of a task written by perf as COMM:PID [PRIO] (where COMM may contain spaces and colons).
+ * parameters:
+ *   start - the start of the part of the line containing the task
+ *   end - the end of the part of the line containing the task
+ *   pid - where to store the PID
+ * returns:
+ *   A pointer to the first character after the priority, or NULL if there is no such task
+ */
+const char *parse_task(const char *start, const char *end, unsigned long *pid) {
+  const char *bracket = NULL;
+  for (const char *c = end - 1; c > start; c--) {
+    if (*c == '[' && c[-1] == ' ') {
+      bracket = c - 1;
+      break;
+    }
+  }
+  if (!bracket) {
+    return NULL;
+  }
+  const char *digits = bracket;
+  while (digits > start && digits[-1] >= '0' && digits[-1] <= '9') {
+    digits--;
+  }
+  if (digits == bracket || digits == start || digits[-1] != ':') {
+    return NULL;
+  }
+  *pid = strtoul(digits, NULL, 10);
+  const char *close = memchr(bracket, ']', end - bracket);
+  return close ? close + 1 : NULL;
+}
+
+/*
+ * Parses a sched_switch event, in either perf's older format (COMM:PID [PRIO] STATE ==> COMM:PID [PRIO]) or
+ * the key=value format of ftrace and newer versions of perf, recording the tasks switched out and in.
+ * parameters:
+ *   conv - the conversion
+ *   fields - the event's fields (after its name)
+ *   end - the end of the line
+ *   time - when the event occurred (ns)
+ * returns:
+ *   1 if the event was recorded, 0 if it couldn't be parsed, -1 if the task table couldn't be grown
+ */
+int parse_switch(converter *conv, const char *fields, const char *end, unsigned long long time) {
+  const char *arrow = NULL;
+  for (const char *c = fields; c + 3 <= end; c++) {
+    if (c[0] == '=' && c[1] == '=' && c[2] == '>') {
+      arrow = c;
+      break;
+    }
+  }
+  if (!arrow) {
+    return 0;
+  }
+
+  unsigned long prev_pid;
+  unsigned long next_pid;
+  const char *state;
+  if (parse_key(fields, arrow, " prev_pid=", &prev_pid)) {
+    unsigned long unused;
+    state = parse_key(fields, arrow, " prev_state=", &unused);
+    if (!state || !parse_key(arrow, end, " next_pid=", &next_pid)) {
+      return 0;
+    }
+  } else {
+    state = parse_task(fields, arrow, &prev_pid);
+    if (!state || !parse_task(arrow + 3, end, &next_pid)) {
+      return 0;
+    }
+    while (*state == ' ') {
+      state++;
+    }
+  }
+
+  // R (or R+) means the task was preempted, anything else that it blocked, slept or exited
+  int runnable = *state == 'R' && (state[1] == '+' || state[1] == ' ' || state[1] == '\n' || state[1] == '\0');
+  if (switch_out(conv, prev_pid, runnable, time) != 0 || switch_in(conv, next_pid, 1, time) != 0) {
+    return -1;
+  }
+  return 1;
+}
+
+/*
+ * Parses a sched_wakeup or sched_wakeup_new event (COMM:PID [PRIO] ... in perf's older format, or
+ * comm=COMM pid=PID ... otherwise), recording that the task has become runnable.
+ * parameters:
+ *   conv - the conversion
+ *   fields - the event's fields (after its name)
+ *   end - the end of the line
+ *   time - when the event occurred (ns)
+ * returns:
+ *   1 if the event was recorded, 0 if it couldn't be parsed, -1 if the task table couldn't be grown
+ */
+int parse_wakeup(converter *conv, const char *fields, const char *end, unsigned long long time) {
+  unsigned long pid;
+  if (!parse_key(fields, end, " pid=", &pid) && !parse_task(fields, end, &pid)) {
+    return 0;
+  }
+  return switch_in(conv, pid, 0, time) == 0 ? 1 : -1;
+}
+
+/*
+ * Parses a line of the trace, recording the event on it (if it's a sched_switch or wakeup event).
+ * parameters:
+ *   conv - the conversion
+ *   line - the line
+ *   length - the length of the line
+ * returns:
+ *   0 if successful (including lines without an event), -1 if the task table couldn't be grown
+ */
+int parse_line(converter *conv, const char *line, size_t length) {
+  const char *end = line + length;
+  const char *event = strstr(line, " sched_");
+  if (!event) {
+    event = strstr(line, ":sched_");
+  }
+  if (!event) {
+    return 0;
+  }
+  event++;
+
+  int is_switch = strncmp(event, "sched_switch:", 13) == 0;
+  int is_wakeup = strncmp(event, "sched_wakeup:", 13) == 0 || strncmp(event, "sched_wakeup_new:", 17) == 0;
+  if (!is_switch && !is_wakeup) {
+    return 0;
+  }
+  conv->events++;
+  unsigned long long time;
+  if (!parse_timestamp(line, event, &time)) {
+    conv->skipped++;
+    return 0;
+  }
+  if (!conv->started) {
+    conv->started = 1;
+    conv->start = time;
+  }
+  if (time < conv->last) {
+    time = conv->last;  // events from different CPUs can be slightly out of order
+  }
+  conv->last = time;
+
+  const char *fields = strchr(event, ':') + 1;
+  int result = is_switch ? parse_switch(conv, fields, end, time) : parse_wakeup(conv, fields, end, time);
+  if (result == 0) {
+    conv->skipped++;
+  }
+  return result < 0 ? -1 : 0;
+}
+
+/*
+ * Converts a trace to a schedule, writing the schedule as each burst ends, then the number of processes at
+ * the start of the schedule (which is padded to COUNT_WIDTH digits with leading zeros, so it can be
+ * overwritten).
+ * parameters:
+ *   conv - the conversion (with its output file and tick set)
+ *   in - the trace
+ * returns:
+ *   0 if successful, 1 if the schedule couldn't be written (after printing an appropriate error message)
+ */
+int convert(converter *conv, FILE *in) {
+  fprintf(conv->out, "%0*d\n", COUNT_WIDTH, 0);
+  char *line = NULL;
+  size_t size = 0;
+  ssize_t length;
+  while ((length = getline(&line, &size, in)) != -1) {
+    if (parse_line(conv, line, length) != 0) {
+      fprintf(stderr, "Unable to allocate memory for %lu tasks!\n", conv->table.count);
+      free(line);
+      return 1;
+    }
+  }
+  free(line);
+
+  // Bursts still going at the end of the trace are cut short there
+  for (unsigned long i = 0; i < conv->table.capacity; i++) {
+    trace_task *task = &conv->table.tasks[i];
+    if (task->pid && task->in_burst) {
+      stop_running(task, conv->last);
+      end_burst(conv, task);
+    }
+  }
+
+  if (fseek(conv->out, 0, SEEK_SET) != 0) {
+    perror("Unable to write the number of processes");
+    return 1;
+  }
+  fprintf(conv->out, "%0*lu", COUNT_WIDTH, conv->written);
+  return 0;
+}
+
+/*
+ * Prints out usage information for the program.
+ * parameters:
+ *   cmd - the command used to start the program
+ *   error - the error message that should be displayed (ignored if NULL)
+ */
+void usage(char *cmd, char *error) {
+  if (error) {
+    fprintf(stderr, "Error: %s\n\n", error);
+  }
+
+  fprintf(stderr, "Usage: %s [-t NS] -o SCHEDULE [TRACE]\n", cmd);
+  fprintf(stderr, "Where:\n");
+  fprintf(stderr, "\t-t, --tick NS\t\tthe length of a time unit in nanoseconds (defaults to %d, 1ms)\n", DEFAULT_TICK);
+  fprintf(stderr, "\t-o, --output FILE\tthe file to write the schedule to (which must be seekable)\n");
+  fprintf(stderr, "\tTRACE\t\t\tthe output of perf sched script or an ftrace dump (defaults to standard input)\n");
+}
+
+/*
+ *  Program entry point.
+ *  Converts the trace to a schedule, then prints out a summary of the conversion.
+ */
+int main(int argc, char *argv[]) {
+  converter conv = {{NULL, 0, 0}, NULL, DEFAULT_TICK, 0, 0, 0, 1, 0, 0, 0, 0, 0};
+  char *filename = NULL;
+
+  static struct option long_options[] = {
+    {"tick", required_argument, NULL, 't'},
+    {"output", required_argument, NULL, 'o'},
+    {NULL, 0, NULL, 0}
+  };
+  int opt;
+  while ((opt = getopt_long(argc, argv, "t:o:", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 't': conv.tick = strtoull(optarg, NULL, 10); break;
+      case 'o': filename = optarg; break;
+      default:
+        usage(argv[0], "Invalid command line arguments");
+        return -1;
+    }
+  }
+  if (argc - optind > 1 || !filename || conv.tick < 1) {
+    usage(argv[0], "An output file (and at most one trace) must be given, and the tick must be at least 1");
+    return -1;
+  }
+
+  FILE *in = stdin;
+  if (optind < argc && strcmp(argv[optind], "-") != 0) {
+    in = fopen(argv[optind], "r");
+    if (!in) {
+      fprintf(stderr, "Unable to read %s!\n", argv[optind]);
+      return 1;
+    }
+  }
+  conv.out = fopen(filename, "w");
+  if (!conv.out) {
+    fprintf(stderr, "Unable to write %s!\n", filename);
+    return 1;
+  }
+  setvbuf(in, NULL, _IOFBF, 1 << 20);
+  setvbuf(conv.out, NULL, _IOFBF, 1 << 20);
+
+  int result = convert(&conv, in);
+  if (fclose(conv.out) != 0 && result == 0) {
+    fprintf(stderr, "Unable to write %s!\n", filename);
+    result = 1;
+  }
+  if (in != stdin) {
+    fclose(in);
+  }
+  free(conv.table.tasks);
+  if (result != 0) {
+    return result;
+  }
+
+  fprintf(stderr, "Converted %lu events (%lu unparsable) from %lu tasks to %lu processes\n", conv.events, conv.skipped,
+      conv.table.count, conv.written);
+  if (conv.written == 0) {
+    fprintf(stderr, "Warning: no processes were found (the trace needs sched_switch events)\n");
+  }
+  if (conv.written >= SIMULATOR_LIMIT || conv.next_pid >= SIMULATOR_LIMIT || conv.largest_arrival >= SIMULATOR_LIMIT
+      || conv.largest_processing >= SIMULATOR_LIMIT) {
+    fprintf(stderr, "Warning: the schedule exceeds the simulator's limits (fewer than 1,000,000 processes, PIDs and "
+        "times), try a longer tick or a shorter trace\n");
+  }
+  return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ * Builds a scheduling algorithm as a module that can be loaded while the simulator runs,
+ * so several algorithms can be run by one simulator (see the -m option of the simulator).
+ * Each module has its own copy of the algorithm's global variables, and only exports a
+ * scheduler_module (named by SCHEDULER_MODULE_SYMBOL) pointing to the algorithm's functions.
+ * Build with (where SCHEDULER_SOURCE is the algorithm to build, defaulting to "scheduler.c"):
+ *   gcc -shared -fPIC -fvisibility=hidden -DSCHEDULER_SOURCE='"algorithms/fcfs.c"' -o fcfs.so module.c
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+// The interface the scheduling algorithm implements
+#include "scheduler.h"
+
+// Modules never run in debug mode, as the output of several algorithms would be interleaved
+bool debug = FALSE;
+
+// The file where the functions declared in scheduler.h need to be defined
+#ifndef SCHEDULER_SOURCE
+#define SCHEDULER_SOURCE "scheduler.c"
+#endif
+#include SCHEDULER_SOURCE
+
+/* The algorithm's functions, which are all the module exports */
+__attribute__((visibility("default"))) const scheduler_module exported_scheduler = {
+  add_to_ready_queue,
+  get_next_scheduled_process,
+  save_scheduler_state,
+  load_scheduler_state
+};
@@ -0,0 +1,294 @@
+/*
+ * A runner that executes a command (such as the simulator) with limits on its resources, and reports the
+ * resources it used. The command is started with setrlimit caps on its CPU time, address space and the size
+ * of the files it writes, so a runaway scheduling algorithm is stopped (or fails to allocate memory) rather
+ * than using up the machine. Once it exits, its CPU time, peak memory use and context switches (from
+ * getrusage) are written as a single line of JSON, to sit alongside the simulator's summary.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+/* The address space limit by default, in megabytes */
+#define DEFAULT_MEMORY 1024
+
+/* The file size limit by default, in megabytes */
+#define DEFAULT_FILE_SIZE 256
+
+/* The limits on the command's resources (0 for no limit) */
+typedef struct limits {
+  rlim_t cpu_seconds;  // the CPU time (user and system) the command may use
+  rlim_t address_space;  // the size of the command's virtual memory (bytes)
+  rlim_t file_size;  // the size of any file the command writes (bytes)
+} limits;
+
+/* The process running the command, which signals sent to the runner are passed on to */
+static volatile pid_t child = 0;
+
+/*
+ * Parses a duration in the same format as timeout(1): a number, optionally followed by s (seconds),
+ * m (minutes), h (hours) or d (days).
+ * parameters:
+ *   text - the duration to parse
+ *   seconds - where to store the duration, rounded up to a whole number of seconds
+ * returns:
+ *   1 if the duration was valid, 0 otherwise
+ */
+int parse_duration(const char *text, rlim_t *seconds) {
+  char *end;
+  double value = strtod(text, &end);
+  double scale = 1;
+  switch (*end) {
+    case '\0': case 's': break;
+    case 'm': scale = 60; break;
+    case 'h': scale = 60 * 60; break;
+    case 'd': scale = 24 * 60 * 60; break;
+    default: return 0;
+  }
+  if (end == text || (*end != '\0' && end[1] != '\0') || value < 0) {
+    return 0;
+  }
+  value *= scale;
+  *seconds = (rlim_t) value + ((rlim_t) value < value ? 1 : 0);
+  return 1;
+}
+
+/*
+ * Parses a size in megabytes.
+ * parameters:
+ *   text - the number of megabytes
+ *   bytes - where to store the size in bytes
+ * returns:
+ *   1 if the size was valid, 0 otherwise
+ */
+int parse_megabytes(const char *text, rlim_t *bytes) {
+  char *end;
+  unsigned long megabytes = strtoul(text, &end, 10);
+  if (end == text || *end != '\0') {
+    return 0;
+  }
+  *bytes = (rlim_t) megabytes << 20;
+  return 1;
+}
+
+/*
+ * Caps a resource of the calling process, unless the limit is 0 (no limit).
+ * parameters:
+ *   resource - the resource to limit (e.g., RLIMIT_CPU)
+ *   soft - the limit at which the process is signalled or its requests fail
+ *   hard - the limit at which it is killed (for CPU time), which it can't raise the soft limit past
+ * returns:
+ *   1 if the limit was set (or there was none), 0 otherwise
+ */
+int set_limit(int resource, rlim_t soft, rlim_t hard) {
+  if (soft == 0) {
+    return 1;
+  }
+  struct rlimit limit = {soft, hard};
+  return setrlimit(resource, &limit) == 0;
+}
+
+/*
+ * Passes a signal sent to the runner (e.g., by timeout) on to the command.
+ * parameters:
+ *   sig - the signal
+ */
+void forward_signal(int sig) {
+  if (child > 0) {
+    kill(child, sig);
+  }
+}
+
+/*
+ * Runs the command with the given limits and waits for it to exit.
+ * parameters:
+ *   command - the command and its arguments (NULL terminated)
+ *   lim - the limits on the command's resources
+ *   status - where to store the command's wait status
+ *   usage - where to store the resources the command used
+ * returns:
+ *   1 if the command was run, 0 if it could not be started
+ */
+int run(char *command[], const limits *lim, int *status, struct rusage *usage) {
+  // (the command's handlers go back to the defaults when it is executed)
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = forward_signal;
+  sigaction(SIGTERM, &action, NULL);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGHUP, &action, NULL);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    fprintf(stderr, "Unable to start %s!\n", command[0]);
+    return 0;
+  }
+  if (pid == 0) {
+    // The hard CPU limit is a second later, so the command is sent SIGXCPU before it is killed
+    if (!set_limit(RLIMIT_CPU, lim->cpu_seconds, lim->cpu_seconds + 1) ||
+        !set_limit(RLIMIT_AS, lim->address_space, lim->address_space) ||
+        !set_limit(RLIMIT_FSIZE, lim->file_size, lim->file_size)) {
+      fprintf(stderr, "Unable to limit the resources of %s!\n", command[0]);
+      _exit(126);
+    }
+    execvp(command[0], command);
+    fprintf(stderr, "Unable to run %s!\n", command[0]);
+    _exit(errno == ENOENT ? 127 : 126);
+  }
+
+  child = pid;
+  while (wait4(pid, status, 0, usage) < 0) {
+    if (errno != EINTR) {
+      fprintf(stderr, "Unable to wait for %s!\n", command[0]);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*
+ * Converts a time from getrusage to microseconds.
+ * parameters:
+ *   tv - the time
+ * returns:
+ *   The time in microseconds
+ */
+long long microseconds(struct timeval tv) {
+  return tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+/*
+ * Writes the way the command exited and the resources it used as a single line of JSON.
+ * parameters:
+ *   fp - the file to write to
+ *   status - the command's wait status
+ *   usage - the resources the command used
+ *   wall_time - the time the command took to run (in microseconds)
+ */
+void print_usage(FILE *fp, int status, const struct rusage *usage, long long wall_time) {
+  fprintf(fp, "{\"exit_status\": %d, \"signal\": %d, \"wall_time_us\": %lld, \"user_time_us\": %lld, "
+      "\"system_time_us\": %lld, \"max_rss_kb\": %ld, \"voluntary_context_switches\": %ld, "
+      "\"involuntary_context_switches\": %ld}\n",
+      WIFEXITED(status) ? WEXITSTATUS(status) : -1, WIFSIGNALED(status) ? WTERMSIG(status) : 0, wall_time,
+      microseconds(usage->ru_utime), microseconds(usage->ru_stime), usage->ru_maxrss, usage->ru_nvcsw,
+      usage->ru_nivcsw);
+}
+
+/*
+ * Describes why the command was killed by the given signal (in particular, if it was due to one of the limits).
+ * parameters:
+ *   sig - the signal that killed the command
+ * returns:
+ *   A description of the signal
+ */
+const char *describe_signal(int sig) {
+  switch (sig) {
+    case SIGXCPU: return "exceeded the CPU time limit";
+    case SIGXFSZ: return "exceeded the file size limit";
+    case SIGKILL: return "killed (possibly for exceeding the CPU time limit)";
+    case SIGSEGV: return "segmentation fault (possibly from exceeding the address space limit)";
+    default: return strsignal(sig);
+  }
+}
+
+/*
+ * Prints out usage information for the program.
+ * parameters:
+ *   cmd - the command the program was started with
+ *   error - an error message to print out first, or NULL
+ */
+void usage(char *cmd, char *error) {
+  if (error) {
+    fprintf(stderr, "Error: %s\n\n", error);
+  }
+
+  fprintf(stderr, "Usage: %s [-t DURATION] [-m MB] [-f MB] [-r FILE] [--] COMMAND [ARGUMENT]...\n", cmd);
+  fprintf(stderr, "Where:\n");
+  fprintf(stderr, "\t-t, --cpu DURATION\tthe CPU time the command may use, as for timeout(1), e.g. 30s or 1m (defaults "
+      "to no limit)\n");
+  fprintf(stderr, "\t-m, --memory MB\t\tthe address space the command may use (defaults to %d, 0 for no limit)\n",
+      DEFAULT_MEMORY);
+  fprintf(stderr, "\t-f, --file-size MB\tthe size of any file the command writes, including a redirected output\n"
+      "\t\t\t\t(defaults to %d, 0 for no limit)\n", DEFAULT_FILE_SIZE);
+  fprintf(stderr, "\t-r, --resources FILE\tthe file to write the resources the command used to, as JSON (defaults to "
+      "standard error)\n");
+  fprintf(stderr, "\tCOMMAND\t\t\tthe command to run (with its arguments), which exits with the command's status\n"
+      "\t\t\t\t(or 128 plus the signal that killed it)\n");
+}
+
+/*
+ *  Program entry point.
+ *  Runs the command with the limits, then writes out the resources it used.
+ */
+int main(int argc, char *argv[]) {
+  limits lim = {0, (rlim_t) DEFAULT_MEMORY << 20, (rlim_t) DEFAULT_FILE_SIZE << 20};
+  char *resources_filename = NULL;
+
+  static struct option long_options[] = {
+    {"cpu", required_argument, NULL, 't'},
+    {"memory", required_argument, NULL, 'm'},
+    {"file-size", required_argument, NULL, 'f'},
+    {"resources", required_argument, NULL, 'r'},
+    {NULL, 0, NULL, 0}
+  };
+  int opt;
+  // (+ stops at the command, so its own options aren't parsed)
+  while ((opt = getopt_long(argc, argv, "+t:m:f:r:", long_options, NULL)) != -1) {
+    int valid = 1;
+    switch (opt) {
+      case 't': valid = parse_duration(optarg, &lim.cpu_seconds); break;
+      case 'm': valid = parse_megabytes(optarg, &lim.address_space); break;
+      case 'f': valid = parse_megabytes(optarg, &lim.file_size); break;
+      case 'r': resources_filename = optarg; break;
+      default:
+        usage(argv[0], "Invalid command line arguments");
+        return -1;
+    }
+    if (!valid) {
+      usage(argv[0], "Durations must be numbers (with an optional s, m, h or d), and sizes whole numbers");
+      return -1;
+    }
+  }
+  if (optind == argc) {
+    usage(argv[0], "A command must be given");
+    return -1;
+  }
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int status;
+  struct rusage used;
+  if (!run(&argv[optind], &lim, &status, &used)) {
+    return 126;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  long long wall_time = (end.tv_sec - start.tv_sec) * 1000000LL + (end.tv_nsec - start.tv_nsec) / 1000;
+
+  FILE *fp = stderr;
+  if (resources_filename) {
+    fp = fopen(resources_filename, "w");
+    if (!fp) {
+      fprintf(stderr, "Unable to write %s!\n", resources_filename);
+      fp = stderr;
+    }
+  }
+  print_usage(fp, status, &used, wall_time);
+  if (fp != stderr) {
+    fclose(fp);
+  }
+
+  if (WIFSIGNALED(status)) {
+    fprintf(stderr, "%s was stopped: %s\n", argv[optind], describe_signal(WTERMSIG(status)));
+    return 128 + WTERMSIG(status);
+  }
+  return WEXITSTATUS(status);
+}
@@ -0,0 +1,110 @@
+/*
+ * The interface between the simulator (and the other tools that drive a scheduling
+ * algorithm) and the file implementing the algorithm.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Cross-platform specification of booleans */
+#define TRUE (1 == 1)
+#define FALSE !TRUE
+typedef int bool;
+
+// Specifies whether we are in debug mode (which is useful for determining whether to print out debug messages).
+extern bool debug;
+
+/* Initial data read in for a process */
+typedef struct process_initial {
+    unsigned int pid;  // the process id
+    unsigned int processing_time;  // the total amount of processing time required for this process
+    unsigned int arrival_time;  // the time this process arrived in the system
+    unsigned int tickets;  // the share of the CPU this process is entitled to (used by proportional-share algorithms)
+    unsigned int deadline;  // the time by which this process should finish, or NO_DEADLINE (used by real-time algorithms)
+} process_initial;
+
+/* The deadline of a process that doesn't have one */
+#define NO_DEADLINE 0
+
+/*
+ * Adds the given process to the ready queue, indicating it is ready to be scheduled.
+ * parameters:
+ *   process - the process to add to the ready queue
+ */
+void add_to_ready_queue(const process_initial process);
+
+/*
+ * Determines the next process to the sceduled.
+ * returns:
+ *   The PID of the process to be scheduled next, or 0 if no process should be scheduled
+ */
+unsigned int get_next_scheduled_process();
+
+/*
+ * Optionally, an algorithm can support the simulator's checkpoints (so a long simulation can be resumed
+ * after it is stopped) by defining these functions, which write its state (e.g., its ready queue) to a
+ * checkpoint and read it back in. They are declared weak, so they are NULL if they aren't defined.
+ * parameters:
+ *   fp - the checkpoint file, positioned where the state should be written (or read from)
+ * returns:
+ *   TRUE if the state was written (or read in) successfully, FALSE otherwise
+ */
+bool save_scheduler_state(FILE *fp) __attribute__((weak));
+bool load_scheduler_state(FILE *fp) __attribute__((weak));
+
+/*
+ * Records that the scheduling algorithm has read the parameter with the given name, so the simulator can warn
+ * about a parameter that is set but never read (e.g., because its name is misspelt). It is defined by the
+ * simulator, and is NULL in a module (which can't see the simulator's functions).
+ * parameters:
+ *   name - the name of the parameter
+ */
+void scheduler_parameter_read(const char *name) __attribute__((weak));
+
+/*
+ * Determines the value of a tunable parameter of the scheduling algorithm (e.g., a quantum or weight),
+ * so it can be changed without recompiling. A parameter is set by the environment variable
+ * SCHEDULER_<name> (which the simulator's -p option sets).
+ * parameters:
+ *   name - the name of the parameter
+ *   default_value - the value to use if the parameter is not set (or is not a number)
+ * returns:
+ *   The value of the parameter
+ */
+static inline double scheduler_parameter(const char *name, double default_value) {
+    if (scheduler_parameter_read) {
+      scheduler_parameter_read(name);
+    }
+    char variable[256];
+    snprintf(variable, sizeof(variable), "SCHEDULER_%s", name);
+    const char *value = getenv(variable);
+    if (!value) {
+      return default_value;
+    }
+    char *end;
+    double parameter = strtod(value, &end);
+    if (end == value || *end != '\0') {
+      fprintf(stderr, "Ignoring invalid value %s for parameter %s\n", value, name);
+      return default_value;
+    }
+    return parameter;
+}
+
+/*
+ * The functions implementing a scheduling algorithm, so an algorithm can be used through pointers
+ * (e.g., when it is built as a module with module.c and loaded while the simulator runs).
+ */
+typedef struct scheduler_module {
+    void (*add_to_ready_queue)(const process_initial process);
+    unsigned int (*get_next_scheduled_process)();
+    bool (*save_scheduler_state)(FILE *fp);  // NULL if the algorithm doesn't support checkpoints
+    bool (*load_scheduler_state)(FILE *fp);  // NULL if the algorithm doesn't support checkpoints
+} scheduler_module;
+
+/* The name of the scheduler_module exported by a module built with module.c */
+#define SCHEDULER_MODULE_SYMBOL "exported_scheduler"
+
+#endif
@@ -1,73 +1,170 @@
+import argparse
 import csv
+import math
 import sqlite3
 import sys
 
 
-usage = """Processes a CSV file with columns Submission,Schedule,Average to determine a score for the COSC240 scheduling competition.
+description = """Processes a CSV file with columns Submission,Schedule,Average to determine a score for the COSC240 scheduling
+competition.
 
-Usage: python3 {} FILE [SCORE]
-Where:
-  FILE is a CSV that contains Submission,Schedule,Average
-  SCORE is the maximum score for the competition (defaults to 100)
+Each schedule ranks the submissions by their average (a missing or invalid average ranks last, and scores 0), and a
+submission scores 1 - (rank - 1) / (largest rank) for it. If the CSV has the resources the simulations used (the
+user_time_us, system_time_us and max_rss_kb columns written by aggregate_results.py when cosc240_a4.sh is run with -r),
+submissions with the same average are ranked by their CPU time (user plus system), so the more efficient one wins. A submission's mark is its mean score across the schedules,
+scaled to SCORE, and the marks are output as "submission mark" lines, in order of submission.
+"""
+
+epilog = """Example:
+  python3 {} output/custom/competition.csv 10
+  python3 {} --by-schedule schedules.csv --by-submission submissions.csv output/custom/competition.csv 10
 """
 
 
-def main(file, score = 100):
+# The number of rows inserted at a time
+BATCH_SIZE = 100000
+
+
+# The columns of the resources each simulation used, if the CSV has them (with the CPU time being user plus system)
+RESOURCE_COLUMNS = ('user_time_us', 'system_time_us', 'max_rss_kb')
+
+
+def read_number(value):
+    """Reads a number from a CSV field, returning None if it is invalid (or infinite)"""
+    try:
+        value = float(value)
+    except ValueError:
+        return None
+    return value if math.isfinite(value) else None
+
+
+def read_results(file):
+    """
+    Reads (submission, schedule, average, cpu time, peak memory) from the given CSV file a row at a time, with None for
+    invalid averages and for resources that are invalid or not in the file
+    """
+    reader = csv.reader(file)
+    header = next(reader, [])
+    try:
+        columns = [header.index(name) for name in ('Submission', 'Schedule', 'Average')]
+    except ValueError:
+        raise ValueError('The file must have Submission, Schedule and Average columns')
+    resource_columns = [header.index(name) for name in RESOURCE_COLUMNS] \
+        if all(name in header for name in RESOURCE_COLUMNS) else []
+
+    for row in reader:
+        if len(row) <= max(columns + resource_columns):
+            continue
+        submission, schedule, average = (row[column] for column in columns)
+        cpu_time = max_rss = None
+        if resource_columns:
+            user_time, system_time, max_rss = (read_number(row[column]) for column in resource_columns)
+            if user_time is not None and system_time is not None:
+                cpu_time = user_time + system_time
+        yield submission, schedule, read_number(average), cpu_time, max_rss
+
+
+def load_results(conn, file):
+    """
+    Loads the results in the given CSV file into the results table, in batches. Submissions and schedules are stored
+    by number (with their names in the submissions and schedules tables), as integers are much quicker to sort.
+    """
+    submissions = {}
+    schedules = {}
+    batch = []
+    for submission, schedule, average, cpu_time, max_rss in read_results(file):
+        batch.append((submissions.setdefault(submission, len(submissions)),
+                      schedules.setdefault(schedule, len(schedules)), average, cpu_time, max_rss))
+        if len(batch) == BATCH_SIZE:
+            conn.executemany('INSERT INTO results VALUES (?,?,?,?,?)', batch)
+            batch = []
+    conn.executemany('INSERT INTO results VALUES (?,?,?,?,?)', batch)
+    conn.executemany('INSERT INTO submissions VALUES (?,?)', ((id, name) for name, id in submissions.items()))
+    conn.executemany('INSERT INTO schedules VALUES (?,?)', ((id, name) for name, id in schedules.items()))
+
+
+def rank_results(conn):
+    """
+    Scores every result in one pass (into the scores table): the results for each schedule are ranked by average (then
+    by CPU time, if known), with the NULL averages tied for last place, and each is scored relative to the largest rank
+    for the schedule
+    """
+    conn.execute('''
+        INSERT INTO scores
+        SELECT submission, schedule, average, cpu_time, max_rss, rank, max(rank) OVER (PARTITION BY schedule),
+               CASE WHEN average IS NULL THEN 0 ELSE 1 - (rank - 1) / (max(rank) OVER (PARTITION BY schedule) * 1.0) END
+        FROM (SELECT submission, schedule, average, cpu_time, max_rss,
+                     RANK() OVER (PARTITION BY schedule ORDER BY average IS NULL, average,
+                                  CASE WHEN average IS NULL THEN NULL ELSE cpu_time END IS NULL,
+                                  CASE WHEN average IS NULL THEN NULL ELSE cpu_time END) AS rank
+              FROM results)''')
+
+
+def write_breakdown(conn, filename, header, query, parameters=()):
+    """Writes the rows of the given query to a CSV file with the given header, as they are produced"""
+    with open(filename, 'w', newline='') as file:
+        writer = csv.writer(file, lineterminator='\n')
+        writer.writerow(header)
+        writer.writerows(('NULL' if value is None else value for value in row)
+                         for row in conn.execute(query, parameters))
+
+
+def main(args):
     """Processes the given CSV file to determine a score for each Submission"""
 
     # Create database in memory
     conn = sqlite3.connect(':memory:')
-    c = conn.cursor()
-    c.execute('CREATE TABLE results (submission text, schedule text, average real)')
-    c.execute('CREATE TABLE ranks (submission text, schedule text, rank integer, max_rank integer)')
-    c.execute('CREATE TABLE max_ranks (schedule text, max_rank integer)')
-    c.execute('CREATE TABLE scores (submission text, schedule text, score real)')
-
-    # Insert CSV rows into database
-    with open(file) as csv_file:
-        reader = csv.DictReader(csv_file)
-        for row in reader:
-            submission = row['Submission']
-            schedule = row['Schedule']
-            average = row['Average']
-            # Ensure any invalid floats are NULL
-            try:
-                float(average)
-            except ValueError:
-                average = 'NULL'
-            c.execute('INSERT INTO results VALUES (?,?,?)', (submission, schedule, average))
-
-    # Determine the maximum value of average
-    max_val = 0
-    for row in c.execute('SELECT average FROM results'):
-        if row[0] != 'NULL' and float(row[0]) > max_val:
-            max_val = float(row[0])
-
-    # Update all NULL values to have the worst average
-    c.execute('UPDATE results SET average=? WHERE average IS NULL OR average = "NULL"', (max_val + 1,))
-
-    # Rank all submissions by average for each schedule
-    c.execute('INSERT INTO ranks SELECT submission, schedule, RANK() OVER (PARTITION BY schedule ORDER BY average), 0 FROM results')
-
-    # Calculate maximum ranks for each schedule
-    c.execute('INSERT INTO max_ranks SELECT schedule, MAX(rank) FROM ranks GROUP BY schedule')
-    c.execute('UPDATE ranks SET max_rank = (SELECT max_rank FROM max_ranks WHERE ranks.schedule=max_ranks.schedule)')
-
-    # Calculate scores
-    c.execute('INSERT INTO scores SELECT submission, schedule, (1-(rank-1)/(max_rank*1.0)) AS score FROM ranks')
-    c.execute('UPDATE scores SET score = 0 WHERE (submission, schedule) IN (SELECT submission, schedule FROM results WHERE average=?)', (max_val + 1,))
-
-    # Output scores
-    for row in c.execute(f'SELECT submission, round(avg(score)*{score},1) as mark from scores GROUP BY submission'):
-        print(row[0],row[1])
+    conn.execute('CREATE TABLE submissions (id integer PRIMARY KEY, name text)')
+    conn.execute('CREATE TABLE schedules (id integer PRIMARY KEY, name text)')
+    conn.execute('CREATE TABLE results (submission integer, schedule integer, average real, cpu_time real, '
+                 'max_rss real)')
+    conn.execute('CREATE TABLE scores (submission integer, schedule integer, average real, cpu_time real, '
+                 'max_rss real, rank integer, max_rank integer, score real)')
+
+    # Insert CSV rows into database, then rank and score them
+    try:
+        with open(args.file, newline='') as csv_file:
+            load_results(conn, csv_file)
+    except (OSError, ValueError) as error:
+        print(f'Unable to read {args.file} ({error})', file=sys.stderr)
+        return 1
+    rank_results(conn)
+
+    # Output scores (as each is calculated)
+    for submission, mark in conn.execute('SELECT submissions.name, round(avg(score)*?,1) AS mark '
+                                         'FROM scores JOIN submissions ON submission = submissions.id '
+                                         'GROUP BY submission ORDER BY submissions.name', (args.score,)):
+        print(submission, mark)
+
+    # Output breakdowns
+    if args.by_submission:
+        write_breakdown(conn, args.by_submission, ['Submission', 'Schedule', 'Average', 'CPU time (us)',
+                                                   'Max RSS (KB)', 'Rank', 'Max rank', 'Score'],
+                        'SELECT submissions.name, schedules.name, average, CAST(cpu_time AS integer), '
+                        'CAST(max_rss AS integer), rank, max_rank, round(score, 4) '
+                        'FROM scores JOIN submissions ON submission = submissions.id '
+                        'JOIN schedules ON schedule = schedules.id ORDER BY submissions.name, schedules.name')
+    if args.by_schedule:
+        write_breakdown(conn, args.by_schedule, ['Schedule', 'Submissions', 'Failed', 'Best', 'Mean', 'Winners'],
+                        'SELECT schedules.name, count(*), count(*) - count(average), min(average), '
+                        'round(avg(average), 2), group_concat(CASE WHEN rank = 1 AND average IS NOT NULL '
+                        'THEN submissions.name END, \' \') '
+                        'FROM scores JOIN submissions ON submission = submissions.id '
+                        'JOIN schedules ON schedule = schedules.id GROUP BY schedule ORDER BY schedules.name')
+    return 0
 
 
 if __name__ == "__main__":
     # Process arguments
-    if not (2 <= len(sys.argv) <= 3):
-        print(usage.format(sys.argv[0]))
-        sys.exit(1)
-
-    file = sys.argv[1]
-    score = 100 if len(sys.argv) <= 2 else int(sys.argv[2])
-    main(file, score)
+    parser = argparse.ArgumentParser(description=description, epilog=epilog.format(sys.argv[0], sys.argv[0]),
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--by-submission', metavar='CSV',
+                        help='a file to write the average, resources used (if known), rank and score of each '
+                             'submission for each schedule to')
+    parser.add_argument('--by-schedule', metavar='CSV',
+                        help='a file to write the number of submissions (and failures), the best and mean averages, and '
+                             'the winners of each schedule to')
+    parser.add_argument('file', help='a CSV that contains Submission,Schedule,Average')
+    parser.add_argument('score', nargs='?', type=int, default=100,
+                        help='the maximum score for the competition (defaults to 100)')
+    sys.exit(main(parser.parse_args()))
@@ -8,37 +8,31 @@
 #include <errno.h>
 #include <limits.h>
 #include <string.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <time.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
 
-/* Cross-platform specification of booleans */
-#define TRUE (1 == 1)
-#define FALSE !TRUE
-typedef int bool;
+// The interface the scheduling algorithm implements
+#include "scheduler.h"
 
 // Specifies whether we are in debug mode (which is useful for determining whether to print out debug messages).
 bool debug = FALSE;
 
-/* Initial data read in for a process */
-typedef struct process_initial {
-    unsigned int pid;  // the process id
-    unsigned int processing_time;  // the total amount of processing time required for this process
-    unsigned int arrival_time;  // the time this process arrived in the system
-} process_initial;
-
-/*
- * Adds the given process to the ready queue, indicating it is ready to be scheduled.
- * parameters:
- *   process - the process to add to the ready queue
- */
-void add_to_ready_queue(const process_initial process);
-
-/*
- * Determines the next process to the sceduled.
- * returns:
- *   The PID of the process to be scheduled next, or 0 if no process should be scheduled
- */
-unsigned int get_next_scheduled_process();
-
-// The file where the above two functions need to be defined
+// The file where the functions declared in scheduler.h need to be defined
 #include "scheduler.c"
 
 /* The maximum length of a line to read */
@@ -50,6 +44,18 @@ const int TIMEOUT = 1000000;
 /* The largest process id supported by the simulator */
 const int MAX_PID = 999999;
 
+/* The number of tickets a process has if none are given in the schedule */
+const unsigned int DEFAULT_TICKETS = 100;
+
+/* The number of time steps between checkpoints if no interval is given */
+const unsigned int DEFAULT_CHECKPOINT_INTERVAL = 100000;
+
+/* The start of every checkpoint file (which changes if the format of checkpoints changes) */
+const char CHECKPOINT_MAGIC[8] = "SIMCKPT1";
+
+/* The start of every checkpoint of a streaming simulation (which changes if their format changes) */
+const char STREAM_CHECKPOINT_MAGIC[8] = "SIMSTRM1";
+
 /* Stats of a process to be simulated */
 typedef struct process_stats {
     process_initial initial;  // initial process data
@@ -57,6 +63,38 @@ typedef struct process_stats {
     unsigned int end_time;  // the time this process finished execution
 } process_stats;
 
+/* The processes read in from a schedule, which are shared (read only) by every simulation of the schedule */
+typedef struct process_table {
+    process_initial *processes;  // the processes, in the order they were read in
+    unsigned int num_processes;  // the number of processes
+    unsigned int *arrival_order;  // the index of each process, sorted by arrival time (then the order read in)
+    unsigned int *pid_indexes;  // one more than the index of the process with each PID, or 0 if there is no such process
+} process_table;
+
+/* A simulation of a scheduling algorithm processing a schedule */
+typedef struct simulation {
+    const char *name;  // the name of the scheduling algorithm
+    scheduler_module scheduler;  // the scheduling algorithm's functions
+    process_stats *processes;  // the stats of each process, in the same order as the process_table
+    unsigned int num_remaining;  // the number of processes that still require more processing time
+    unsigned int next_arrival;  // the position in the process_table's arrival_order of the next process to arrive
+    unsigned int time;  // the next time step to simulate (when run by run_simulation)
+    bool failed;  // whether the scheduling algorithm has scheduled an invalid process
+} simulation;
+
+/* Where, and how often, to save checkpoints of a simulation */
+typedef struct checkpoint_options {
+    const char *filename;  // the file to save checkpoints to
+    unsigned int interval;  // the number of time steps between checkpoints
+} checkpoint_options;
+
+/* The result of simulating a single time step */
+typedef enum step_result {
+    STEP_OK,  // the time step was simulated successfully
+    STEP_INVALID_PID,  // a process that does not exist was scheduled
+    STEP_TOO_LONG  // a process was scheduled after it had completed
+} step_result;
+
 /*
  * Converts the given string to an unsigned integer.
  * Similar to the standard strtoul, only ensures value is a valid unsigned integer.
@@ -77,9 +115,28 @@ unsigned int strtoui(const char *s, char **endptr, int base) {
   return (unsigned int) val;
 }
 
+/*
+ * Converts the given string to an unsigned integer, if the string contains one before the next field.
+ * parameters:
+ *   s - the string to convert to an unsigned integer
+ *   endptr - the character after the end of the unsigned integer (or s, if the field is empty)
+ *   default_value - the value to use if the field is empty
+ * returns:
+ *   The result of strtoui(s, endptr, 10), or default_value if s begins with ',' or a new line
+ * side effects:
+ *   Sets the value of errno to ERANGE if the value read in is greater than INT_MAX
+ */
+unsigned int read_optional_field(const char *s, char **endptr, unsigned int default_value) {
+  if (*s == ',' || *s == '\n') {
+    *endptr = (char *) s;
+    return default_value;
+  }
+  return strtoui(s, endptr, 10);
+}
+
 /*
   * Reads in a single line from the given file pointer and extracts a process from it.
-  * It is assumed that the line with have the format "pid,arrival_time,processing_time".
+  * It is assumed that the line with have the format "pid,arrival_time,processing_time[,tickets[,deadline]]".
   * parameters:
   *   fp - the file pointer to read from
   * returns:
@@ -121,103 +178,302 @@ process_initial read_process_initial(FILE* fp) {
     // Read in processing_time, starting from one character beyond where the pid finished
     unsigned int processing_time = strtoui(end + 1, &end, 10);
     // Ensure PID invalid if there was an error
+    if (errno != 0 || (*end != '\n' && *end != ',')) {
+      pid = 0;
+    }
+
+    // Read in the optional number of tickets, starting from one character beyond where the processing_time finished
+    unsigned int tickets = DEFAULT_TICKETS;
+    if (*end == ',') {
+      tickets = read_optional_field(end + 1, &end, DEFAULT_TICKETS);
+    }
+
+    // Read in the optional deadline, starting from one character beyond where the tickets finished
+    unsigned int deadline = NO_DEADLINE;
+    if (*end == ',') {
+      deadline = read_optional_field(end + 1, &end, NO_DEADLINE);
+    }
+    // Ensure PID invalid if there was an error
     if (errno != 0 || *end != '\n') {
       pid = 0;
     }
 
     // Set up and return structure
-    process_initial initial = {pid, processing_time, arrival_time};
+    process_initial initial = {pid, processing_time, arrival_time, tickets, deadline};
     return initial;
 }
 
 /*
- * Determine if there is still any process that requires more processing time
+ * Determine the index of the process with the given PID.
+ * parmeters:
+ *   pid - the PID to search for
+ *   table - the processes to check
+ * returns:
+ *   The array index of the process with the given PID, or -1 if it is not found
+ */
+unsigned int get_pid_index(unsigned int pid, const process_table *table) {
+  if (pid > MAX_PID) {
+    return -1;
+  }
+  return table->pid_indexes[pid] - 1;
+}
+
+/*
+ * Sets up a simulation of the given scheduling algorithm processing the given processes.
  * parameters:
- *   processes - an array of the process_stats to check
- *   num_processes - the number of processes in the given array
+ *   sim - the simulation to set up
+ *   name - the name of the scheduling algorithm
+ *   scheduler - the scheduling algorithm's functions
+ *   table - the processes to simulate
  * returns:
- *   TRUE if any process still requires more processing time, FALSE otherwise
+ *   TRUE if the simulation was set up, FALSE if there was not enough memory
  */
-bool still_running(process_stats processes[], unsigned int num_processes) {
-  for (unsigned int i = 0; i < num_processes; i++) {
-    if (processes[i].processed_time < processes[i].initial.processing_time) {
-      return TRUE;
-    }
+bool init_simulation(simulation *sim, const char *name, scheduler_module scheduler, const process_table *table) {
+  sim->name = name;
+  sim->scheduler = scheduler;
+  sim->num_remaining = table->num_processes;
+  sim->next_arrival = 0;
+  sim->time = 0;
+  sim->failed = FALSE;
+  sim->processes = malloc(table->num_processes * sizeof(process_stats));
+  if (!sim->processes) {
+    return FALSE;
   }
-  return FALSE;
+  for (unsigned int i = 0; i < table->num_processes; i++) {
+    process_stats process = {table->processes[i], 0, 0};
+    sim->processes[i] = process;
+  }
+  return TRUE;
 }
 
 /*
- * Determine the index of the process with the given PID.
- * parmeters:
- *   pid - the PID to search for
- *   processes - an array of the processes to check
- *   num_processes - the number of processes in the given array
+ * Simulates a single time step, adding any processes that arrive to the ready queue and
+ * giving the scheduled process a time unit of execution.
+ * parameters:
+ *   sim - the simulation to advance
+ *   table - the processes being simulated
+ *   time - the time step to simulate
+ *   pid - where to store the PID of the process scheduled (or 0 if none was scheduled)
  * returns:
- *   The array index of the process with the given PID, or -1 if it is not found
+ *   STEP_OK if the time step was simulated successfully, or the reason it failed otherwise
  */
-unsigned int get_pid_index(unsigned int pid, process_stats processes[], unsigned int num_processes) {
-  for (unsigned int i = 0; i < num_processes; i++) {
-    if (processes[i].initial.pid == pid) {
-      return i;
+step_result simulate_time_step(simulation *sim, const process_table *table, unsigned int time, unsigned int *pid) {
+  // Add any new processes to the queue
+  while (sim->next_arrival < table->num_processes &&
+      table->processes[table->arrival_order[sim->next_arrival]].arrival_time <= time) {
+    sim->scheduler.add_to_ready_queue(table->processes[table->arrival_order[sim->next_arrival]]);
+    sim->next_arrival++;
+  }
+
+  // Find process to schedule
+  *pid = sim->scheduler.get_next_scheduled_process();
+
+  // If a process is scheduled:
+  if (*pid > 0) {
+    // Find the process
+    unsigned int index = get_pid_index(*pid, table);
+    if (index >= table->num_processes) {
+      return STEP_INVALID_PID;
+    }
+    // Give the selected process a time unit of execution
+    process_stats *process = &sim->processes[index];
+    process->processed_time++;
+    // Check if process has ended
+    if (process->processed_time == process->initial.processing_time) {
+      process->end_time = time;
+      sim->num_remaining--;
+    } else if (process->processed_time > process->initial.processing_time) {
+      return STEP_TOO_LONG;
     }
   }
-  return -1;
+  return STEP_OK;
+}
+
+/*
+ * Saves a checkpoint of the given simulation, so it can be resumed with load_checkpoint.
+ * The checkpoint is written to a temporary file that then replaces the checkpoint file, so if the simulator is
+ * stopped while saving, the previous checkpoint is left intact.
+ * parameters:
+ *   filename - the file to save the checkpoint to
+ *   sim - the simulation to save (run by run_simulation)
+ *   table - the processes being simulated
+ * returns:
+ *   TRUE if the checkpoint was saved, FALSE otherwise
+ */
+bool save_checkpoint(const char *filename, const simulation *sim, const process_table *table) {
+    char temp_filename[strlen(filename) + 5];
+    snprintf(temp_filename, sizeof(temp_filename), "%s.tmp", filename);
+    FILE *fp = fopen(temp_filename, "wb");
+    if (!fp) {
+      return FALSE;
+    }
+
+    // Record how much has been output, so output after the checkpoint can be discarded when resuming
+    fflush(stdout);
+    long output_offset = ftell(stdout);
+
+    bool written = fwrite(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC), 1, fp) == 1 &&
+        fwrite(&table->num_processes, sizeof(unsigned int), 1, fp) == 1 &&
+        fwrite(table->processes, sizeof(process_initial), table->num_processes, fp) == table->num_processes &&
+        fwrite(&sim->time, sizeof(unsigned int), 1, fp) == 1 &&
+        fwrite(&sim->num_remaining, sizeof(unsigned int), 1, fp) == 1 &&
+        fwrite(&sim->next_arrival, sizeof(unsigned int), 1, fp) == 1 &&
+        fwrite(&output_offset, sizeof(long), 1, fp) == 1;
+    for (unsigned int i = 0; written && i < table->num_processes; i++) {
+      unsigned int progress[2] = {sim->processes[i].processed_time, sim->processes[i].end_time};
+      written = fwrite(progress, sizeof(progress), 1, fp) == 1;
+    }
+    written = written && sim->scheduler.save_scheduler_state(fp);
+    written = fflush(fp) == 0 && fsync(fileno(fp)) == 0 && written;
+    if (fclose(fp) != 0 || !written || rename(temp_filename, filename) != 0) {
+      remove(temp_filename);
+      return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+ * Discards any output written after a checkpoint was saved, so a simulation resumed from the checkpoint continues
+ * the output from where the checkpoint was saved. This is only possible if the output is being written to the
+ * same file as when the checkpoint was saved.
+ * parameters:
+ *   output_offset - the amount that had been output when the checkpoint was saved (or -1 if unknown)
+ */
+void restore_output(long output_offset) {
+    struct stat status;
+    if (output_offset < 0 || fstat(fileno(stdout), &status) != 0 || !S_ISREG(status.st_mode)) {
+      return;
+    }
+    if (status.st_size < output_offset) {
+      fprintf(stderr, "Warning: the output from before the checkpoint is not in the output file\n");
+      return;
+    }
+    fflush(stdout);
+    if (ftruncate(fileno(stdout), output_offset) != 0 || fseek(stdout, output_offset, SEEK_SET) != 0) {
+      fprintf(stderr, "Warning: unable to discard the output from after the checkpoint\n");
+    }
 }
 
 /*
- * Runs the simulation from start to finish.
+ * Runs the simulation from its next time step to the finish, outputting the process scheduled at each time step.
  * parameters:
- *   processes - an array of processes to simulate
- *   num_processes - the number of processes in the given array
+ *   sim - the simulation to run
+ *   table - the processes to simulate
  *   time_bound - the time limit for the simulation - if the simulation has not finished in that time, it is a failure
+ *   quiet - whether to leave out the process scheduled at each time step (only outputting errors)
+ *   checkpoint - where and how often to save checkpoints (or NULL if checkpoints should not be saved)
  * returns:
  *   TRUE if the simulation completed successfully, FALSE otherwise
  */
-bool run_simulation(process_stats processes[], unsigned int num_processes, unsigned int time_bound) {
-    printf("Time\tPID\n");
+bool run_simulation(simulation *sim, const process_table *table, unsigned int time_bound, bool quiet,
+    const checkpoint_options *checkpoint) {
+    if (!quiet && sim->time == 0) {
+      printf("Time\tPID\n");
+    }
     // Continue running as long as a process still requires more processing time and we haven't run out of time
-    for (unsigned int time = 0; time < time_bound && still_running(processes, num_processes); time++) {
+    while (sim->time < time_bound && sim->num_remaining > 0) {
+      unsigned int time = sim->time;
+      unsigned int pid;
+      step_result result = simulate_time_step(sim, table, time, &pid);
+      if (result == STEP_INVALID_PID) {
+        // Invalid process scheduled - stop
+        printf("Invalid pid %d!\n", pid);
+        return FALSE;
+      } else if (result == STEP_TOO_LONG) {
+        // Process scheduled for too long - stop
+        printf("Process %d scheduled for too long!\n", pid);
+        return FALSE;
+      }
 
-      // Add any new processes to the queue
-      for (unsigned int i = 0; i < num_processes; i++) {
-        if (processes[i].initial.arrival_time == time) {
-          add_to_ready_queue(processes[i].initial);
+      // Output time step
+      if (!quiet) {
+        if (pid > 0) {
+          printf("%d:\t%d\n", time, pid);
+        } else {
+          printf("%d:\t\n", time);
         }
       }
 
-      // Find process to schedule
-      unsigned int pid = get_next_scheduled_process();
-
-      // If a process is scheduled:
-      if (pid > 0) {
-        // Find the process
-        unsigned int index = get_pid_index(pid, processes, num_processes);
-        if (index < 0) {
-          // Invalid process scheduled - stop
-          printf("Invalid pid %d!\n", pid);
-          return FALSE;
-        }
-        // Give the selected process a time unit of execution
-        processes[index].processed_time++;
-        // Check if process has ended
-        if (processes[index].processed_time == processes[index].initial.processing_time) {
-          processes[index].end_time = time;
-        } else if (processes[index].processed_time > processes[index].initial.processing_time) {
-          // Process scheduled for too long - stop
-          printf("Process %d scheduled for too long!\n", pid);
-          return FALSE;
-        }
+      // Save a checkpoint every interval time steps (carrying on without it if it can't be saved)
+      sim->time++;
+      if (checkpoint && sim->time % checkpoint->interval == 0 && sim->num_remaining > 0 &&
+          !save_checkpoint(checkpoint->filename, sim, table)) {
+        fprintf(stderr, "Warning: unable to save checkpoint to %s\n", checkpoint->filename);
       }
+    }
+    return sim->num_remaining == 0;
+}
 
-      // Output time step
-      if (pid > 0) {
-        printf("%d:\t%d\n", time, pid);
-      } else {
-        printf("%d:\t\n", time);
+/* The simulations run by a single thread in lockstep */
+typedef struct lockstep_group {
+    simulation *sims;  // the simulations to run
+    unsigned int num_simulations;  // the number of simulations
+    const process_table *table;  // the processes to simulate
+    unsigned int time_bound;  // the time limit for the simulations
+} lockstep_group;
+
+/*
+ * Runs several simulations of the same processes in lockstep, so each simulates a time step
+ * before any simulates the next, without outputting the process scheduled at each time step.
+ * A simulation that schedules an invalid process is marked as failed and stops.
+ * parameters:
+ *   arg - the lockstep_group to run
+ * returns:
+ *   NULL (so it can be run as a thread)
+ */
+void *run_lockstep(void *arg) {
+  lockstep_group *group = arg;
+  for (unsigned int time = 0; time < group->time_bound; time++) {
+    bool running = FALSE;
+    for (unsigned int i = 0; i < group->num_simulations; i++) {
+      simulation *sim = &group->sims[i];
+      if (!sim->failed && sim->num_remaining > 0) {
+        unsigned int pid;
+        sim->failed = simulate_time_step(sim, group->table, time, &pid) != STEP_OK;
+        running = TRUE;
       }
     }
-    return !still_running(processes, num_processes);
+    if (!running) {
+      break;
+    }
+  }
+  return NULL;
+}
+
+/*
+ * Runs several simulations of the same processes to completion, spreading them over the given number of threads.
+ * parameters:
+ *   sims - the simulations to run
+ *   num_simulations - the number of simulations
+ *   table - the processes to simulate
+ *   time_bound - the time limit for the simulations
+ *   num_threads - the number of threads to use
+ */
+void run_simulations(simulation sims[], unsigned int num_simulations, const process_table *table, unsigned int time_bound,
+    unsigned int num_threads) {
+  if (num_threads > num_simulations) {
+    num_threads = num_simulations;
+  }
+  pthread_t threads[num_threads];
+  lockstep_group groups[num_threads];
+  bool started[num_threads];
+  for (unsigned int i = 0; i < num_threads; i++) {
+    // Give each thread an equal share of the simulations (with earlier threads taking any remainder)
+    unsigned int first = i * (num_simulations / num_threads) + (i < num_simulations % num_threads ? i : num_simulations % num_threads);
+    unsigned int count = num_simulations / num_threads + (i < num_simulations % num_threads ? 1 : 0);
+    lockstep_group group = {&sims[first], count, table, time_bound};
+    groups[i] = group;
+    // The first group is run by this thread once the others have started
+    started[i] = i > 0 && pthread_create(&threads[i], NULL, run_lockstep, &groups[i]) == 0;
+  }
+  for (unsigned int i = 0; i < num_threads; i++) {
+    if (started[i]) {
+      pthread_join(threads[i], NULL);
+    } else {
+      // Either the first group, or a thread could not be started, so run the simulations in this thread
+      run_lockstep(&groups[i]);
+    }
+  }
 }
 
 /*
@@ -280,8 +536,101 @@ double calculate_average_wait_time(process_stats processes[], unsigned int num_p
   return average_wait;
 }
 
+/*
+ * Compares two unsigned integers, for sorting them into ascending order with qsort.
+ * parameters:
+ *   a - a pointer to the first unsigned integer
+ *   b - a pointer to the second unsigned integer
+ * returns:
+ *   A negative number if a is smaller than b, a positive number if a is larger than b, or 0 if they are the same
+ */
+int compare_unsigned(const void *a, const void *b) {
+    unsigned int x = *(const unsigned int *) a;
+    unsigned int y = *(const unsigned int *) b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Calculates a percentile of the turnaround times of the given processes (using the nearest-rank method).
+ * parameters:
+ *   processes - an array of processes to calculate the percentile turnaround time for
+ *   num_processes - the number of processes
+ *   percentile - the percentile to calculate (from 1 to 100)
+ * returns:
+ *   The smallest turnaround time that is at least as large as the given percent of the turnaround times,
+ *   or 0 if there are no processes (or there is not enough memory to sort them)
+ */
+unsigned int calculate_percentile_turnaround_time(process_stats processes[], unsigned int num_processes,
+    unsigned int percentile) {
+  unsigned int *turnaround_times = malloc(num_processes * sizeof(unsigned int));
+  if (num_processes == 0 || !turnaround_times) {
+    free(turnaround_times);
+    return 0;
+  }
+  for (unsigned int i = 0; i < num_processes; i++) {
+    turnaround_times[i] = calculate_turnaround_time(processes[i]);
+  }
+  qsort(turnaround_times, num_processes, sizeof(unsigned int), compare_unsigned);
+
+  // The rank is the percentile of the number of processes, rounded up
+  unsigned long rank = (percentile * (unsigned long) num_processes + 99) / 100;
+  unsigned int percentile_turnaround = turnaround_times[rank > 0 ? rank - 1 : 0];
+  free(turnaround_times);
+  return percentile_turnaround;
+}
+
+/*
+ * Calculates how late the given process finished.
+ * parameters:
+ *   process - The process to calculate the lateness for
+ * returns:
+ *   The time the process finished after its deadline, or 0 if it has no deadline or met it
+ */
+unsigned int calculate_lateness(process_stats process) {
+    if (process.initial.deadline == NO_DEADLINE || process.end_time + 1 <= process.initial.deadline) {
+      return 0;
+    }
+    return process.end_time + 1 - process.initial.deadline;
+}
+
+/* Statistics on how well the deadlines of processes were met */
+typedef struct deadline_stats {
+    bool has_deadlines;  // whether any process has a deadline
+    unsigned int deadline_misses;  // the number of processes that finished after their deadline
+    unsigned long total_lateness;  // the sum of the lateness of every process
+    unsigned int maximum_lateness;  // the largest lateness of any process
+} deadline_stats;
+
+/*
+ * Calculates how well the deadlines of the given processes were met.
+ * parameters:
+ *   processes - an array of processes to calculate the deadline statistics for
+ *   num_processes - the number of processes
+ * returns:
+ *   The deadline statistics for the given processes
+ */
+deadline_stats calculate_deadline_stats(process_stats processes[], unsigned int num_processes) {
+    deadline_stats stats = {FALSE, 0, 0, 0};
+    for (unsigned int i = 0; i < num_processes; i++) {
+      if (processes[i].initial.deadline != NO_DEADLINE) {
+        stats.has_deadlines = TRUE;
+        unsigned int lateness = calculate_lateness(processes[i]);
+        if (lateness > 0) {
+          stats.deadline_misses++;
+          stats.total_lateness += lateness;
+          if (lateness > stats.maximum_lateness) {
+            stats.maximum_lateness = lateness;
+          }
+        }
+      }
+    }
+    return stats;
+}
+
 /*
  * Prints out average turnaround time and average wait time for the given processes.
+ * If any process has a deadline, also prints out the number of deadlines missed, and the total
+ * and maximum lateness.
  * parameters:
  *   processes - an array of processes to display statistics for
  *   num_processes - the number of processes
@@ -289,106 +638,1786 @@ double calculate_average_wait_time(process_stats processes[], unsigned int num_p
 void print_statistics(process_stats processes[], unsigned int num_processes) {
     printf("Average turnaround time:\t%.2f\n", calculate_average_turnaround_time(processes, num_processes));
     printf("Average wait time:\t%.2f\n", calculate_average_wait_time(processes, num_processes));
+
+    deadline_stats stats = calculate_deadline_stats(processes, num_processes);
+    if (stats.has_deadlines) {
+      printf("Deadline misses:\t%u\n", stats.deadline_misses);
+      printf("Total lateness:\t%lu\n", stats.total_lateness);
+      printf("Maximum lateness:\t%u\n", stats.maximum_lateness);
+    }
 }
 
 /*
- * Prints out usage information fdr the program.
+ * Prints out a table comparing the statistics of the given simulations, with a row for each simulation.
  * parameters:
- *   cmd - the command used to start the program
- *   error - the error message that should be displayed (ignored if NULL)
+ *   sims - the simulations to compare (which must all have finished running)
+ *   num_simulations - the number of simulations
+ *   table - the processes that were simulated
  */
-void usage(char *cmd, char *error) {
-  if (error) {
-    printf("Error: %s\n\n", error);
-  }
+void print_comparison(simulation sims[], unsigned int num_simulations, const process_table *table) {
+    deadline_stats stats = calculate_deadline_stats(sims[0].processes, table->num_processes);
+    printf("Algorithm\tAverage turnaround time\tAverage wait time");
+    if (stats.has_deadlines) {
+      printf("\tDeadline misses\tTotal lateness\tMaximum lateness");
+    }
+    printf("\n");
 
-  printf("Usage: %s [-d] FILE\n", cmd);
-  printf("Where:\n");
-  printf("\t-d\tspecifies that the simulator should execute in debug mode\n");
-  printf("\tFILE\tis the name of the file to read processes from\n");
+    for (unsigned int i = 0; i < num_simulations; i++) {
+      simulation *sim = &sims[i];
+      if (sim->failed || sim->num_remaining > 0) {
+        printf("%s\tfailed\n", sim->name);
+        continue;
+      }
+      printf("%s\t%.2f\t%.2f", sim->name,
+          calculate_average_turnaround_time(sim->processes, table->num_processes),
+          calculate_average_wait_time(sim->processes, table->num_processes));
+      if (stats.has_deadlines) {
+        stats = calculate_deadline_stats(sim->processes, table->num_processes);
+        printf("\t%u\t%lu\t%u", stats.deadline_misses, stats.total_lateness, stats.maximum_lateness);
+      }
+      printf("\n");
+    }
 }
 
+/* The statistics of a simulation, as written to its summary */
+typedef struct simulation_summary {
+    bool completed;  // whether every process finished within the time limit
+    unsigned long num_processes;  // the number of processes in the schedule
+    unsigned long time_steps;  // the number of time steps simulated
+    double average_turnaround;  // the average turnaround time (if completed)
+    double average_wait;  // the average wait time (if completed)
+    unsigned int percentile_turnaround;  // the 99th percentile turnaround time (if completed)
+    deadline_stats deadlines;  // how well the deadlines were met (if completed)
+} simulation_summary;
+
 /*
- *  Program entry point.
- *  Checks the required command line argument (which should be the name of the file to process) is present,
- *  attempts to read in the file, and runs the simulations.
+ * Writes a summary of a simulation to the given file, as a single line of JSON, so the results of many simulations
+ * can be collected without parsing their output. The averages have the same precision as in the output.
+ * parameters:
+ *   filename - the name of the file to write the summary to
+ *   summary - the statistics of the simulation
+ * returns:
+ *   TRUE if the summary was written, FALSE otherwise
  */
-int main(int argc, char *argv[]) {
-    // Check arguments
-    char *filename = NULL;
-    if (argc == 2) {
-      filename = argv[1];
-    } else if (argc == 3 && strcmp(argv[1], "-d") == 0) {
-      debug = TRUE;
-      filename = argv[2];
+bool write_summary(const char *filename, const simulation_summary *summary) {
+    FILE *fp = fopen(filename, "w");
+    if (!fp) {
+      return FALSE;
     }
-    if (!filename) {
-        usage(argv[0], "Invalid command line arguments");
-        return -1;
+    fprintf(fp, "{\"completed\": %s, \"processes\": %lu, \"time_steps\": %lu",
+        summary->completed ? "true" : "false", summary->num_processes, summary->time_steps);
+    if (summary->completed) {
+      fprintf(fp, ", \"average_turnaround_time\": %.2f, \"average_wait_time\": %.2f, \"p99_turnaround_time\": %u",
+          summary->average_turnaround, summary->average_wait, summary->percentile_turnaround);
+      if (summary->deadlines.has_deadlines) {
+        fprintf(fp, ", \"deadline_misses\": %u, \"total_lateness\": %lu, \"maximum_lateness\": %u",
+            summary->deadlines.deadline_misses, summary->deadlines.total_lateness, summary->deadlines.maximum_lateness);
+      }
     }
+    fprintf(fp, "}\n");
+    return fclose(fp) == 0;
+}
 
-    // Attempt to open file
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
-        printf("Unable to read %s!\n", filename);
-        return 1;
+/* The processes that have arrived but not yet finished in a streaming simulation, in an open addressing hash table by PID */
+typedef struct live_processes {
+    process_stats *slots;  // the processes (a slot with a PID of 0 is free)
+    unsigned int capacity;  // the number of slots (always a power of 2)
+    unsigned int count;  // the number of processes in the table
+} live_processes;
+
+/* Statistics of the processes that have finished in a streaming simulation, folded in as each one finishes */
+typedef struct running_stats {
+    unsigned long num_processes;  // the number of processes that have finished
+    unsigned long long total_turnaround;  // the sum of their turnaround times
+    unsigned long long total_wait;  // the sum of their wait times
+    deadline_stats deadlines;  // how well their deadlines were met
+    unsigned long *turnaround_counts;  // the number with each turnaround time (the last counts any >= TIMEOUT)
+    unsigned int maximum_turnaround;  // the largest turnaround time
+} running_stats;
+
+/*
+ * Determines the slot of the table the process with the given PID is in, or the free slot it would be added to.
+ * parameters:
+ *   live - the live processes
+ *   pid - the PID to search for
+ * returns:
+ *   The index of the slot
+ */
+unsigned int find_live_slot(const live_processes *live, unsigned int pid) {
+    unsigned int slot = (pid * 2654435761u) & (live->capacity - 1);
+    while (live->slots[slot].initial.pid != 0 && live->slots[slot].initial.pid != pid) {
+      slot = (slot + 1) & (live->capacity - 1);
     }
+    return slot;
+}
 
-    // Attempt to read number of processes
-    unsigned int num_processes;
-    int count = fscanf(fp, "%u\n", &num_processes);
-    if (count == EOF) {
-        printf("Error reading number of processes.\n");
-        printf("Please ensure the file begins with a line containing the number of processes in the file.\n");
-        return 1;
+/*
+ * Adds a process that has arrived to the live processes, growing the table if required.
+ * parameters:
+ *   live - the live processes
+ *   initial - the process that has arrived
+ * returns:
+ *   TRUE if the process was added, FALSE if a live process has the same PID or there is not enough memory
+ *   (after printing an appropriate error message)
+ */
+bool add_live_process(live_processes *live, process_initial initial) {
+    if (2 * (live->count + 1) > live->capacity) {
+      live_processes grown = {calloc(live->capacity ? 2 * live->capacity : 1024, sizeof(process_stats)),
+          live->capacity ? 2 * live->capacity : 1024, live->count};
+      if (!grown.slots) {
+        printf("Unable to allocate memory for %u processes!\n", live->count + 1);
+        return FALSE;
+      }
+      for (unsigned int i = 0; i < live->capacity; i++) {
+        if (live->slots[i].initial.pid != 0) {
+          grown.slots[find_live_slot(&grown, live->slots[i].initial.pid)] = live->slots[i];
+        }
+      }
+      free(live->slots);
+      *live = grown;
     }
-    if (num_processes < 1 || num_processes >= TIMEOUT) {
-        printf("Error reading number of processes.\n");
-        printf("Please ensure there are between 1 and 1,000,000 processes.\n");
-        return 1;
+    unsigned int slot = find_live_slot(live, initial.pid);
+    if (live->slots[slot].initial.pid != 0) {
+      printf("Process %d arrived before the process with the same PID finished!\n", initial.pid);
+      return FALSE;
     }
+    process_stats process = {initial, 0, 0};
+    live->slots[slot] = process;
+    live->count++;
+    return TRUE;
+}
 
-    // Attempt to read processes, giving appropriate error messages if necessary
-    process_stats processes[num_processes];
-    for (unsigned int i = 0; i < num_processes; i++) {
-        process_initial initial = read_process_initial(fp);
-        if (initial.pid == 0) {
-            printf("Error reading process on line %d!\n", i + 1);
-            printf("Please ensure each process line matches the following format (with pid>0):\n");
-            printf("\tpid,processing_time,arrival_time\n");
-            return 1;
-        } else if (initial.pid >= MAX_PID) {
-          printf("Error reading process on line %d!\n", i + 1);
-          printf("Please ensure each process id is less than 1,000,000.\n");
-          return 1;
-        } else {
-          if (initial.arrival_time < 0 || initial.arrival_time >= TIMEOUT) {
-              printf("Error reading process on line %d!\n", i + 1);
-              printf("Please ensure each process has an arrival time between 0 and 1,000,000.\n");
-              return 1;
-          }
-          if (initial.processing_time <= 0 || initial.processing_time >= TIMEOUT) {
-              printf("Error reading process on line %d!\n", i + 1);
-              printf("Please ensure each process has a processing time between 1 and 1,000,000.\n");
-              return 1;
-          }
-          for (unsigned int j = 0; j < i; j++) {
-            if (initial.pid == processes[j].initial.pid) {
-              printf("Error reading process on line %d!\n", i + 1);
-              printf("Please ensure each process's PID is unique.\n");
-              return 1;
-            }
-          }
-          process_stats process = {initial, 0, 0};
-          processes[i] = process;
+/*
+ * Removes the process in the given slot from the live processes, so its slot can be reused.
+ * The processes after it are moved back to fill the gap, so every process can still be found by find_live_slot.
+ * parameters:
+ *   live - the live processes
+ *   slot - the slot of the process to remove
+ */
+void remove_live_process(live_processes *live, unsigned int slot) {
+    unsigned int mask = live->capacity - 1;
+    unsigned int next = (slot + 1) & mask;
+    while (live->slots[next].initial.pid != 0) {
+      // Move the process back to the gap if its home slot isn't between the gap and where it is
+      unsigned int home = (live->slots[next].initial.pid * 2654435761u) & mask;
+      if (((next - home) & mask) >= ((next - slot) & mask)) {
+        live->slots[slot] = live->slots[next];
+        slot = next;
+      }
+      next = (next + 1) & mask;
+    }
+    live->slots[slot].initial.pid = 0;
+    live->count--;
+}
+
+/*
+ * Folds the statistics of a finished process into the running statistics.
+ * parameters:
+ *   stats - the running statistics
+ *   process - the process that has finished
+ */
+void add_finished_process(running_stats *stats, process_stats process) {
+    unsigned int turnaround = calculate_turnaround_time(process);
+    stats->num_processes++;
+    stats->total_turnaround += turnaround;
+    stats->total_wait += calculate_wait_time(process);
+    stats->turnaround_counts[turnaround < TIMEOUT ? turnaround : TIMEOUT]++;
+    if (turnaround > stats->maximum_turnaround) {
+      stats->maximum_turnaround = turnaround;
+    }
+    if (process.initial.deadline != NO_DEADLINE) {
+      stats->deadlines.has_deadlines = TRUE;
+      unsigned int lateness = calculate_lateness(process);
+      if (lateness > 0) {
+        stats->deadlines.deadline_misses++;
+        stats->deadlines.total_lateness += lateness;
+        if (lateness > stats->deadlines.maximum_lateness) {
+          stats->deadlines.maximum_lateness = lateness;
         }
+      }
     }
+}
 
-    // Close file
-    fclose(fp);
+/*
+ * Calculates the smallest turnaround time that at least the given percentage of the finished processes' turnaround
+ * times are no larger than, from the histogram of turnaround times.
+ * parameters:
+ *   stats - the statistics of the processes that have finished
+ *   percentile - the percentage of turnaround times (from 1 to 100)
+ * returns:
+ *   The turnaround time at the given percentile (or the largest turnaround time, if it is beyond the histogram)
+ */
+unsigned int calculate_running_percentile_turnaround_time(const running_stats *stats, unsigned int percentile) {
+    unsigned long rank = (percentile * stats->num_processes + 99) / 100;
+    unsigned long seen = 0;
+    unsigned int turnaround = 0;
+    while (turnaround < TIMEOUT && seen + stats->turnaround_counts[turnaround] < rank) {
+      seen += stats->turnaround_counts[turnaround++];
+    }
+    if (turnaround == TIMEOUT) {
+      // Only the largest of the turnaround times beyond the histogram is known
+      turnaround = stats->maximum_turnaround;
+    }
+    return turnaround;
+}
 
-    // Run simulation for 1,000,000 time steps, outputting results if successful
-    if (run_simulation(processes, num_processes, TIMEOUT)) {
-      print_statistics(processes, num_processes);
+/*
+ * Prints out the running statistics, in the same format as print_statistics.
+ * parameters:
+ *   stats - the running statistics
+ *   quiet - whether to also print out the 99th percentile turnaround time (as for quiet simulations)
+ */
+void print_running_statistics(const running_stats *stats, bool quiet) {
+    double num_processes = stats->num_processes ? stats->num_processes : 1;
+    printf("Average turnaround time:\t%.2f\n", stats->total_turnaround / num_processes);
+    printf("Average wait time:\t%.2f\n", stats->total_wait / num_processes);
+    if (stats->deadlines.has_deadlines) {
+      printf("Deadline misses:\t%u\n", stats->deadlines.deadline_misses);
+      printf("Total lateness:\t%lu\n", stats->deadlines.total_lateness);
+      printf("Maximum lateness:\t%u\n", stats->deadlines.maximum_lateness);
     }
+    if (quiet) {
+      printf("99th percentile turnaround time:\t%u\n", calculate_running_percentile_turnaround_time(stats, 99));
+    }
+}
+
+/* A streaming simulation, which reads in each process just before it arrives */
+typedef struct stream {
+    char *path;  // the absolute path of the schedule (so a checkpoint can reopen it from anywhere)
+    FILE *fp;  // the schedule being read
+    unsigned long num_processes;  // the number of processes in the schedule
+    unsigned long num_read;  // the number of processes read in so far
+    process_initial next;  // the process read in that hasn't arrived yet (with a PID of 0 if there is none)
+    live_processes live;  // the processes that have arrived but not finished
+    running_stats stats;  // the statistics of the processes that have finished
+    unsigned long work_bound;  // when every process that has arrived would finish if the CPU was never idle
+} stream;
+
+/*
+ * Adds the processes that arrive at the given time to the live processes and the ready queue, reading in
+ * processes until one that arrives later is read in.
+ * parameters:
+ *   st - the streaming simulation
+ *   scheduler - the scheduling algorithm's functions
+ *   time - the time step being simulated
+ * returns:
+ *   TRUE if successful, FALSE if a process is invalid (after printing an appropriate error message)
+ */
+bool add_streamed_arrivals(stream *st, scheduler_module scheduler, unsigned int time) {
+    while (st->num_read < st->num_processes || st->next.pid != 0) {
+      if (st->next.pid == 0) {
+        unsigned int previous_arrival = st->next.arrival_time;
+        st->next = read_process_initial(st->fp);
+        st->num_read++;
+        if (st->next.pid == 0 || st->next.processing_time == 0 || st->next.tickets == 0 ||
+            st->next.arrival_time < previous_arrival) {
+          printf("Error reading process on line %lu!\n", st->num_read);
+          printf("Please ensure each process line matches the following format (with pid>0 and processing_time>0),\n");
+          printf("and the processes are in order of arrival time:\n");
+          printf("\tpid,arrival_time,processing_time[,tickets[,deadline]]\n");
+          return FALSE;
+        }
+        // (arrival times, processing times and deadlines are at most INT_MAX, as larger values don't parse)
+        if (st->next.tickets >= TIMEOUT) {
+          printf("Error reading process on line %lu!\n", st->num_read);
+          printf("Please ensure each process has a number of tickets between 1 and 1,000,000.\n");
+          return FALSE;
+        }
+        if (st->next.deadline != NO_DEADLINE && st->next.deadline < st->next.arrival_time) {
+          printf("Error reading process on line %lu!\n", st->num_read);
+          printf("Please ensure each process has a deadline between its arrival time and 2,147,483,647 (or none).\n");
+          return FALSE;
+        }
+      }
+      if (st->next.arrival_time > time) {
+        break;
+      }
+      if (!add_live_process(&st->live, st->next)) {
+        return FALSE;
+      }
+      scheduler.add_to_ready_queue(st->next);
+      st->work_bound = (st->work_bound > time ? st->work_bound : time) + st->next.processing_time;
+      st->next.pid = 0;
+    }
+    return TRUE;
+}
+
+/*
+ * Gives the scheduled process a time unit of execution, folding in its statistics and reusing its slot once it
+ * has finished.
+ * parameters:
+ *   st - the streaming simulation
+ *   pid - the PID of the process scheduled
+ *   time - the time step being simulated
+ * returns:
+ *   TRUE if successful, FALSE if the process isn't live (it doesn't exist, or has already finished)
+ */
+bool run_live_process(stream *st, unsigned int pid, unsigned int time) {
+    unsigned int slot = find_live_slot(&st->live, pid);
+    process_stats *process = &st->live.slots[slot];
+    if (process->initial.pid == 0) {
+      return FALSE;
+    }
+    process->processed_time++;
+    if (process->processed_time == process->initial.processing_time) {
+      process->end_time = time;
+      add_finished_process(&st->stats, *process);
+      remove_live_process(&st->live, slot);
+    }
+    return TRUE;
+}
+
+/*
+ * Closes the schedule of a streaming simulation, and frees its memory.
+ * parameters:
+ *   st - the streaming simulation
+ */
+void close_stream(stream *st) {
+    if (st->fp) {
+      fclose(st->fp);
+    }
+    free(st->path);
+    free(st->live.slots);
+    free(st->stats.turnaround_counts);
+}
+
+/*
+ * Saves a checkpoint of a streaming simulation, so it can be resumed with load_stream_checkpoint. Rather than the
+ * processes, the checkpoint holds where the schedule has been read up to, the live processes, the running
+ * statistics (with only the turnaround times that occurred in the histogram) and the scheduling algorithm's state,
+ * so its size is proportional to the number of unfinished processes. As with save_checkpoint, the checkpoint file
+ * is replaced atomically.
+ * parameters:
+ *   filename - the file to save the checkpoint to
+ *   st - the streaming simulation
+ *   time - the next time step to simulate
+ *   scheduler - the scheduling algorithm's functions
+ * returns:
+ *   TRUE if the checkpoint was saved, FALSE otherwise
+ */
+bool save_stream_checkpoint(const char *filename, const stream *st, unsigned int time, scheduler_module scheduler) {
+    char temp_filename[strlen(filename) + 5];
+    snprintf(temp_filename, sizeof(temp_filename), "%s.tmp", filename);
+    FILE *fp = fopen(temp_filename, "wb");
+    if (!fp) {
+      return FALSE;
+    }
+
+    // Record how much has been output, so output after the checkpoint can be discarded when resuming
+    fflush(stdout);
+    long output_offset = ftell(stdout);
+    long schedule_offset = ftell(st->fp);
+    unsigned int path_length = strlen(st->path);
+    unsigned int num_turnarounds = 0;
+    for (unsigned int i = 0; i <= TIMEOUT; i++) {
+      num_turnarounds += st->stats.turnaround_counts[i] != 0;
+    }
+
+    bool written = fwrite(STREAM_CHECKPOINT_MAGIC, sizeof(STREAM_CHECKPOINT_MAGIC), 1, fp) == 1 &&
+        fwrite(&path_length, sizeof(unsigned int), 1, fp) == 1 &&
+        fwrite(st->path, 1, path_length, fp) == path_length &&
+        fwrite(&schedule_offset, sizeof(long), 1, fp) == 1 &&
+        fwrite(&output_offset, sizeof(long), 1, fp) == 1 &&
+        fwrite(&time, sizeof(unsigned int), 1, fp) == 1 &&
+        fwrite(&st->num_processes, sizeof(unsigned long), 1, fp) == 1 &&
+        fwrite(&st->num_read, sizeof(unsigned long), 1, fp) == 1 &&
+        fwrite(&st->next, sizeof(process_initial), 1, fp) == 1 &&
+        fwrite(&st->work_bound, sizeof(unsigned long), 1, fp) == 1 &&
+        fwrite(&st->stats.num_processes, sizeof(unsigned long), 1, fp) == 1 &&
+        fwrite(&st->stats.total_turnaround, sizeof(unsigned long long), 1, fp) == 1 &&
+        fwrite(&st->stats.total_wait, sizeof(unsigned long long), 1, fp) == 1 &&
+        fwrite(&st->stats.deadlines, sizeof(deadline_stats), 1, fp) == 1 &&
+        fwrite(&st->stats.maximum_turnaround, sizeof(unsigned int), 1, fp) == 1 &&
+        fwrite(&st->live.count, sizeof(unsigned int), 1, fp) == 1 &&
+        fwrite(&num_turnarounds, sizeof(unsigned int), 1, fp) == 1;
+    for (unsigned int i = 0; written && i < st->live.capacity; i++) {
+      if (st->live.slots[i].initial.pid != 0) {
+        written = fwrite(&st->live.slots[i], sizeof(process_stats), 1, fp) == 1;
+      }
+    }
+    for (unsigned int i = 0; written && i <= TIMEOUT; i++) {
+      if (st->stats.turnaround_counts[i] != 0) {
+        written = fwrite(&i, sizeof(unsigned int), 1, fp) == 1 &&
+            fwrite(&st->stats.turnaround_counts[i], sizeof(unsigned long), 1, fp) == 1;
+      }
+    }
+    written = written && scheduler.save_scheduler_state(fp);
+    written = fflush(fp) == 0 && fsync(fileno(fp)) == 0 && written;
+    if (fclose(fp) != 0 || !written || rename(temp_filename, filename) != 0) {
+      remove(temp_filename);
+      return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+ * Reads in a checkpoint saved by save_stream_checkpoint, reopening the schedule where it had been read up to.
+ * parameters:
+ *   filename - the checkpoint file to read
+ *   st - the streaming simulation to set up (which should be closed with close_stream, even if this fails)
+ *   time - where to store the next time step to simulate
+ *   scheduler - the scheduling algorithm's functions (its state is read in with its load_scheduler_state)
+ * returns:
+ *   TRUE if the checkpoint was read in successfully, FALSE otherwise (after printing an error message)
+ */
+bool load_stream_checkpoint(const char *filename, stream *st, unsigned int *time, scheduler_module scheduler) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        printf("Unable to read %s!\n", filename);
+        return FALSE;
+    }
+
+    // Read in the schedule's path, and reopen it where it had been read up to
+    char magic[sizeof(STREAM_CHECKPOINT_MAGIC)];
+    unsigned int path_length;
+    if (fread(magic, sizeof(magic), 1, fp) != 1 || memcmp(magic, STREAM_CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+        fread(&path_length, sizeof(unsigned int), 1, fp) != 1 || path_length == 0 || path_length > PATH_MAX ||
+        !(st->path = calloc(path_length + 1, 1)) || fread(st->path, 1, path_length, fp) != path_length) {
+        printf("%s is not a valid checkpoint of a streaming simulation!\n", filename);
+        fclose(fp);
+        return FALSE;
+    }
+    long schedule_offset;
+    long output_offset;
+    unsigned long num_processes;
+    unsigned int num_live;
+    unsigned int num_turnarounds;
+    bool valid = fread(&schedule_offset, sizeof(long), 1, fp) == 1 &&
+        fread(&output_offset, sizeof(long), 1, fp) == 1 &&
+        fread(time, sizeof(unsigned int), 1, fp) == 1 &&
+        fread(&st->num_processes, sizeof(unsigned long), 1, fp) == 1 &&
+        fread(&st->num_read, sizeof(unsigned long), 1, fp) == 1 &&
+        fread(&st->next, sizeof(process_initial), 1, fp) == 1 &&
+        fread(&st->work_bound, sizeof(unsigned long), 1, fp) == 1 &&
+        fread(&st->stats.num_processes, sizeof(unsigned long), 1, fp) == 1 &&
+        fread(&st->stats.total_turnaround, sizeof(unsigned long long), 1, fp) == 1 &&
+        fread(&st->stats.total_wait, sizeof(unsigned long long), 1, fp) == 1 &&
+        fread(&st->stats.deadlines, sizeof(deadline_stats), 1, fp) == 1 &&
+        fread(&st->stats.maximum_turnaround, sizeof(unsigned int), 1, fp) == 1 &&
+        fread(&num_live, sizeof(unsigned int), 1, fp) == 1 &&
+        fread(&num_turnarounds, sizeof(unsigned int), 1, fp) == 1 &&
+        st->num_read <= st->num_processes && num_turnarounds <= TIMEOUT + 1;
+    if (!valid) {
+        printf("%s is not a valid checkpoint of a streaming simulation!\n", filename);
+        fclose(fp);
+        return FALSE;
+    }
+    st->fp = fopen(st->path, "r");
+    if (!st->fp) {
+        printf("Unable to read %s!\n", st->path);
+        fclose(fp);
+        return FALSE;
+    }
+    if (fscanf(st->fp, "%lu\n", &num_processes) != 1 || num_processes != st->num_processes ||
+        fseek(st->fp, schedule_offset, SEEK_SET) != 0) {
+        printf("%s has changed since the checkpoint was saved!\n", st->path);
+        fclose(fp);
+        return FALSE;
+    }
+
+    // Read in the live processes and the running statistics, then the scheduling algorithm's state
+    st->stats.turnaround_counts = calloc(TIMEOUT + 1, sizeof(unsigned long));
+    if (!st->stats.turnaround_counts) {
+        printf("Unable to allocate memory for the statistics!\n");
+        fclose(fp);
+        return FALSE;
+    }
+    for (unsigned int i = 0; valid && i < num_live; i++) {
+      process_stats process;
+      valid = fread(&process, sizeof(process_stats), 1, fp) == 1 && process.initial.pid != 0 &&
+          add_live_process(&st->live, process.initial);
+      if (valid) {
+        st->live.slots[find_live_slot(&st->live, process.initial.pid)] = process;
+      }
+    }
+    for (unsigned int i = 0; valid && i < num_turnarounds; i++) {
+      unsigned int turnaround;
+      valid = fread(&turnaround, sizeof(unsigned int), 1, fp) == 1 && turnaround <= TIMEOUT &&
+          fread(&st->stats.turnaround_counts[turnaround], sizeof(unsigned long), 1, fp) == 1;
+    }
+    valid = valid && scheduler.load_scheduler_state(fp);
+    fclose(fp);
+    if (!valid) {
+        printf("%s is not a valid checkpoint of a streaming simulation!\n", filename);
+        return FALSE;
+    }
+
+    restore_output(output_offset);
+    return TRUE;
+}
+
+/*
+ * Runs a simulation while reading in the schedule, rather than reading in every process first, so only the
+ * processes that have arrived but not yet finished are kept in memory. Each process's statistics are folded in
+ * to running totals as soon as it finishes, and its slot is reused.
+ * The processes must be in order of arrival time, and a PID can only be reused once the process with that PID
+ * has finished. Schedules may have any number of processes, with arrival times, processing times and deadlines
+ * up to INT_MAX (rather than TIMEOUT). A simulation fails if it runs TIMEOUT time steps past the time every
+ * process that has arrived would have finished by if the CPU was never idle.
+ * parameters:
+ *   filename - the name of the file to read processes from (ignored if resuming)
+ *   scheduler - the scheduling algorithm's functions
+ *   quiet - whether to leave out the process scheduled at each time step (and output the 99th percentile
+ *     turnaround time)
+ *   checkpoint - where and how often to save checkpoints (or NULL if checkpoints should not be saved)
+ *   resume_filename - a checkpoint saved by save_stream_checkpoint to resume the simulation from, or NULL
+ *   summary - where to store the statistics of the simulation, or NULL (left unchanged if the file can't be read)
+ * returns:
+ *   TRUE if the simulation completed successfully (and its statistics were output), FALSE otherwise
+ */
+bool run_streaming_simulation(const char *filename, scheduler_module scheduler, bool quiet,
+    const checkpoint_options *checkpoint, const char *resume_filename, simulation_summary *summary) {
+    stream st = {NULL, NULL, 0, 0, {0, 0, 0, 0, 0}, {NULL, 0, 0}, {0, 0, 0, {FALSE, 0, 0, 0}, NULL, 0}, 0};
+    unsigned int time = 0;
+    if (resume_filename) {
+      if (!load_stream_checkpoint(resume_filename, &st, &time, scheduler)) {
+        close_stream(&st);
+        return FALSE;
+      }
+    } else {
+      st.path = realpath(filename, NULL);
+      st.fp = st.path ? fopen(st.path, "r") : NULL;
+      if (!st.fp) {
+          printf("Unable to read %s!\n", filename);
+          close_stream(&st);
+          return FALSE;
+      }
+      if (fscanf(st.fp, "%lu\n", &st.num_processes) != 1 || st.num_processes < 1) {
+          printf("Error reading number of processes.\n");
+          printf("Please ensure the file begins with a line containing the number of processes in the file.\n");
+          close_stream(&st);
+          return FALSE;
+      }
+      st.stats.turnaround_counts = calloc(TIMEOUT + 1, sizeof(unsigned long));
+      if (!st.stats.turnaround_counts) {
+          printf("Unable to allocate memory for the statistics!\n");
+          close_stream(&st);
+          return FALSE;
+      }
+      if (!quiet) {
+        printf("Time\tPID\n");
+      }
+    }
+
+    bool completed = FALSE;
+    for (; time < UINT_MAX && add_streamed_arrivals(&st, scheduler, time); time++) {
+      if (st.live.count == 0 && st.num_read == st.num_processes && st.next.pid == 0) {
+        completed = TRUE;
+        break;
+      }
+      if (st.live.count > 0 && time >= st.work_bound + TIMEOUT) {
+        break;
+      }
+
+      unsigned int pid = scheduler.get_next_scheduled_process();
+      if (pid > 0 && !run_live_process(&st, pid, time)) {
+        printf("Invalid pid %d!\n", pid);
+        break;
+      }
+
+      // Output time step
+      if (!quiet) {
+        if (pid > 0) {
+          printf("%u:\t%d\n", time, pid);
+        } else {
+          printf("%u:\t\n", time);
+        }
+      }
+
+      // Save a checkpoint every interval time steps (carrying on without it if it can't be saved)
+      if (checkpoint && (time + 1) % checkpoint->interval == 0 &&
+          !save_stream_checkpoint(checkpoint->filename, &st, time + 1, scheduler)) {
+        fprintf(stderr, "Warning: unable to save checkpoint to %s\n", checkpoint->filename);
+      }
+    }
+
+    if (completed) {
+      print_running_statistics(&st.stats, quiet);
+    }
+    if (summary) {
+      double num_processes = st.stats.num_processes ? st.stats.num_processes : 1;
+      summary->completed = completed;
+      summary->num_processes = st.num_processes;
+      summary->time_steps = time;
+      summary->average_turnaround = st.stats.total_turnaround / num_processes;
+      summary->average_wait = st.stats.total_wait / num_processes;
+      summary->percentile_turnaround = calculate_running_percentile_turnaround_time(&st.stats, 99);
+      summary->deadlines = st.stats.deadlines;
+    }
+    close_stream(&st);
+    return completed;
+}
+
+/* The phases of the simulator timed when profiling */
+typedef enum profile_phase {
+    PHASE_PARSE,  // reading in the processes
+    PHASE_VALIDATION,  // checking the processes are valid, and sorting them by arrival time
+    PHASE_SIMULATION,  // simulating the scheduling algorithm(s)
+    PHASE_STATISTICS,  // calculating and outputting the statistics
+    NUM_PHASES
+} profile_phase;
+
+/* The names of the phases, in the same order as profile_phase */
+const char *PHASE_NAMES[NUM_PHASES] = {"parse", "validation", "simulation", "statistics"};
+
+/* The hardware events counted (with perf_event_open) when profiling */
+typedef enum profile_counter {
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_CACHE_MISSES,
+    COUNTER_BRANCH_MISSES,
+    NUM_COUNTERS
+} profile_counter;
+
+/* The names of the hardware events, in the same order as profile_counter */
+const char *COUNTER_NAMES[NUM_COUNTERS] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+
+/* The time and hardware event counts at a point in the program */
+typedef struct profile_sample {
+    struct timespec time;
+    unsigned long long counters[NUM_COUNTERS];
+} profile_sample;
+
+/* The total time and hardware events between pairs of samples */
+typedef struct profile_measurement {
+    unsigned long calls;  // the number of pairs of samples
+    double ns;  // the total nanoseconds between each pair of samples
+    unsigned long long counters[NUM_COUNTERS];  // the total events counted between each pair of samples
+} profile_measurement;
+
+/* The measurements taken when profiling */
+typedef struct profile {
+    double phase_ns[NUM_PHASES];  // the time taken by each phase
+    int counter_fds[NUM_COUNTERS];  // the hardware event counters (the first leads the group), or -1 if unavailable
+    bool counters_available;  // whether the hardware events are being counted
+    scheduler_module scheduler;  // the scheduling algorithm's functions, called by the profiled hooks
+    profile_measurement simulation;  // the measurements of run_simulation
+    profile_measurement add_hook;  // the measurements of add_to_ready_queue
+    profile_measurement next_hook;  // the measurements of get_next_scheduled_process
+} profile;
+
+/* The profile the profiled hooks add their measurements to */
+profile *active_profile = NULL;
+
+/*
+ * Determines the number of nanoseconds between two times.
+ * parameters:
+ *   start - the earlier time
+ *   end - the later time
+ * returns:
+ *   The number of nanoseconds from start to end
+ */
+double elapsed_ns(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+/*
+ * Starts counting the hardware events for this process (in user space), if perf_event_open is available.
+ * parameters:
+ *   prof - the profile to count the events for
+ */
+void open_counters(profile *prof) {
+    prof->counters_available = FALSE;
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+      prof->counter_fds[i] = -1;
+    }
+#ifdef __linux__
+    const unsigned long long configs[NUM_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[i];
+      attr.disabled = i == 0;  // the whole group is enabled through its leader
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      prof->counter_fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : prof->counter_fds[0], 0);
+      if (prof->counter_fds[i] < 0) {
+        // Any counter missing (e.g., in a virtual machine, or if perf_event_paranoid forbids it) - count none
+        for (int j = 0; j < i; j++) {
+          close(prof->counter_fds[j]);
+          prof->counter_fds[j] = -1;
+        }
+        return;
+      }
+    }
+    ioctl(prof->counter_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    prof->counters_available = TRUE;
+#endif
+}
+
+/*
+ * Stops counting the hardware events started by open_counters.
+ * parameters:
+ *   prof - the profile the events were counted for
+ */
+void close_counters(profile *prof) {
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+      if (prof->counter_fds[i] >= 0) {
+        close(prof->counter_fds[i]);
+      }
+    }
+    prof->counters_available = FALSE;
+}
+
+/*
+ * Records the current time and hardware event counts.
+ * parameters:
+ *   prof - the profile counting the events
+ *   sample - where to store the time and event counts
+ */
+void take_sample(profile *prof, profile_sample *sample) {
+    memset(sample->counters, 0, sizeof(sample->counters));
+    if (prof->counters_available) {
+      // A group is read as the number of events, followed by each event's count
+      unsigned long long values[NUM_COUNTERS + 1];
+      if (read(prof->counter_fds[0], values, sizeof(values)) == sizeof(values)) {
+        memcpy(sample->counters, values + 1, sizeof(sample->counters));
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &sample->time);
+}
+
+/*
+ * Adds the time and hardware events since the given sample to the given measurement.
+ * parameters:
+ *   prof - the profile counting the events
+ *   measurement - the measurement to add to
+ *   start - the sample taken at the start of the measurement
+ */
+void add_measurement(profile *prof, profile_measurement *measurement, const profile_sample *start) {
+    profile_sample end;
+    take_sample(prof, &end);
+    measurement->calls++;
+    measurement->ns += elapsed_ns(start->time, end.time);
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+      measurement->counters[i] += end.counters[i] - start->counters[i];
+    }
+}
+
+/*
+ * Adds the given process to the active profile's scheduling algorithm's ready queue, measuring the call.
+ * parameters:
+ *   process - the process to add to the ready queue
+ */
+void profiled_add_to_ready_queue(const process_initial process) {
+    profile_sample start;
+    take_sample(active_profile, &start);
+    active_profile->scheduler.add_to_ready_queue(process);
+    add_measurement(active_profile, &active_profile->add_hook, &start);
+}
+
+/*
+ * Determines the next process to be scheduled by the active profile's scheduling algorithm, measuring the call.
+ * returns:
+ *   The PID of the process to be scheduled next, or 0 if no process should be scheduled
+ */
+unsigned int profiled_get_next_scheduled_process() {
+    profile_sample start;
+    take_sample(active_profile, &start);
+    unsigned int pid = active_profile->scheduler.get_next_scheduled_process();
+    add_measurement(active_profile, &active_profile->next_hook, &start);
+    return pid;
+}
+
+/*
+ * Starts profiling, counting hardware events if possible.
+ * parameters:
+ *   prof - the profile to store the measurements in
+ *   phase_start - where to store the sample the first phase starts from
+ */
+void start_profile(profile *prof, profile_sample *phase_start) {
+    memset(prof, 0, sizeof(profile));
+    open_counters(prof);
+    take_sample(prof, phase_start);
+}
+
+/*
+ * Records the time taken by a phase of the simulator, if profiling.
+ * parameters:
+ *   prof - the profile to store the time in (or NULL if not profiling)
+ *   phase - the phase that has ended
+ *   phase_start - the sample the phase started from, which is updated to start the next phase
+ */
+void end_phase(profile *prof, profile_phase phase, profile_sample *phase_start) {
+    if (prof) {
+      profile_sample end;
+      take_sample(prof, &end);
+      prof->phase_ns[phase] += elapsed_ns(phase_start->time, end.time);
+      *phase_start = end;
+    }
+}
+
+/*
+ * Profiles the given scheduling algorithm, replacing its functions with ones that measure each call.
+ * parameters:
+ *   prof - the profile to store the measurements in
+ *   scheduler - the scheduling algorithm's functions, which are replaced with the profiled ones
+ */
+void profile_scheduler(profile *prof, scheduler_module *scheduler) {
+    prof->scheduler = *scheduler;
+    scheduler->add_to_ready_queue = profiled_add_to_ready_queue;
+    scheduler->get_next_scheduled_process = profiled_get_next_scheduled_process;
+    active_profile = prof;
+}
+
+/*
+ * Prints out a measurement as a JSON object (with null event counts if they weren't counted).
+ * parameters:
+ *   fp - the file to print to
+ *   prof - the profile the measurement was taken by
+ *   name - the name of the measurement
+ *   measurement - the measurement to print
+ */
+void print_measurement(FILE *fp, const profile *prof, const char *name, const profile_measurement *measurement) {
+    fprintf(fp, "  \"%s\": {\"calls\": %lu, \"ns\": %.0f", name, measurement->calls, measurement->ns);
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+      if (prof->counters_available) {
+        fprintf(fp, ", \"%s\": %llu", COUNTER_NAMES[i], measurement->counters[i]);
+      } else {
+        fprintf(fp, ", \"%s\": null", COUNTER_NAMES[i]);
+      }
+    }
+    fprintf(fp, "}");
+}
+
+/*
+ * Prints out the measurements taken when profiling as JSON.
+ * parameters:
+ *   fp - the file to print to
+ *   prof - the measurements to print
+ */
+void print_profile(FILE *fp, const profile *prof) {
+    fprintf(fp, "{\n  \"phases_ns\": {");
+    for (int i = 0; i < NUM_PHASES; i++) {
+      fprintf(fp, "%s\"%s\": %.0f", i > 0 ? ", " : "", PHASE_NAMES[i], prof->phase_ns[i]);
+    }
+    fprintf(fp, "},\n  \"counters_available\": %s,\n", prof->counters_available ? "true" : "false");
+    print_measurement(fp, prof, "run_simulation", &prof->simulation);
+    fprintf(fp, ",\n");
+    print_measurement(fp, prof, "add_to_ready_queue", &prof->add_hook);
+    fprintf(fp, ",\n");
+    print_measurement(fp, prof, "get_next_scheduled_process", &prof->next_hook);
+    fprintf(fp, "\n}\n");
+}
+
+/*
+ * Allocates the memory for a process table.
+ * parameters:
+ *   table - the process table to allocate
+ *   num_processes - the number of processes the table holds
+ * returns:
+ *   TRUE if the memory was allocated, FALSE otherwise (after printing an error message)
+ */
+bool allocate_process_table(process_table *table, unsigned int num_processes) {
+    table->num_processes = num_processes;
+    table->processes = malloc(num_processes * sizeof(process_initial));
+    table->arrival_order = malloc(num_processes * sizeof(unsigned int));
+    table->pid_indexes = calloc(MAX_PID + 1, sizeof(unsigned int));
+    if (!table->processes || !table->arrival_order || !table->pid_indexes) {
+        printf("Unable to allocate memory for %u processes!\n", num_processes);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+ * Reads in the processes from the given file, giving appropriate error messages if necessary.
+ * Only the format of each line is checked - see validate_processes.
+ * parameters:
+ *   filename - the name of the file to read
+ *   table - where to store the processes read in
+ * returns:
+ *   TRUE if the processes were read in successfully, FALSE otherwise
+ */
+bool read_processes(const char *filename, process_table *table) {
+    // Attempt to open file
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        printf("Unable to read %s!\n", filename);
+        return FALSE;
+    }
+
+    // Attempt to read number of processes
+    unsigned int num_processes;
+    int count = fscanf(fp, "%u\n", &num_processes);
+    if (count == EOF) {
+        printf("Error reading number of processes.\n");
+        printf("Please ensure the file begins with a line containing the number of processes in the file.\n");
+        fclose(fp);
+        return FALSE;
+    }
+    if (num_processes < 1 || num_processes >= TIMEOUT) {
+        printf("Error reading number of processes.\n");
+        printf("Please ensure there are between 1 and 1,000,000 processes.\n");
+        fclose(fp);
+        return FALSE;
+    }
+
+    if (!allocate_process_table(table, num_processes)) {
+        fclose(fp);
+        return FALSE;
+    }
+
+    // Attempt to read processes, giving an appropriate error message if necessary
+    for (unsigned int i = 0; i < num_processes; i++) {
+        table->processes[i] = read_process_initial(fp);
+        if (table->processes[i].pid == 0) {
+            printf("Error reading process on line %d!\n", i + 1);
+            printf("Please ensure each process line matches the following format (with pid>0):\n");
+            printf("\tpid,arrival_time,processing_time[,tickets[,deadline]]\n");
+            fclose(fp);
+            return FALSE;
+        }
+    }
+
+    // Close file
+    fclose(fp);
+
+    return TRUE;
+}
+
+/*
+ * Checks that the processes read in by read_processes are valid (their values are within the simulator's limits
+ * and their PIDs are unique), and sorts them by arrival time.
+ * parameters:
+ *   table - the processes read in by read_processes
+ * returns:
+ *   TRUE if the processes are valid, FALSE otherwise (after printing an appropriate error message)
+ */
+bool validate_processes(process_table *table) {
+    for (unsigned int i = 0; i < table->num_processes; i++) {
+        process_initial initial = table->processes[i];
+        if (initial.pid >= MAX_PID) {
+          printf("Error reading process on line %d!\n", i + 1);
+          printf("Please ensure each process id is less than 1,000,000.\n");
+          return FALSE;
+        }
+        if (initial.arrival_time < 0 || initial.arrival_time >= TIMEOUT) {
+            printf("Error reading process on line %d!\n", i + 1);
+            printf("Please ensure each process has an arrival time between 0 and 1,000,000.\n");
+            return FALSE;
+        }
+        if (initial.processing_time <= 0 || initial.processing_time >= TIMEOUT) {
+            printf("Error reading process on line %d!\n", i + 1);
+            printf("Please ensure each process has a processing time between 1 and 1,000,000.\n");
+            return FALSE;
+        }
+        if (initial.tickets <= 0 || initial.tickets >= TIMEOUT) {
+            printf("Error reading process on line %d!\n", i + 1);
+            printf("Please ensure each process has a number of tickets between 1 and 1,000,000.\n");
+            return FALSE;
+        }
+        if (initial.deadline >= TIMEOUT || (initial.deadline != NO_DEADLINE && initial.deadline < initial.arrival_time)) {
+            printf("Error reading process on line %d!\n", i + 1);
+            printf("Please ensure each process has a deadline between its arrival time and 1,000,000 (or none).\n");
+            return FALSE;
+        }
+        if (table->pid_indexes[initial.pid] != 0) {
+            printf("Error reading process on line %d!\n", i + 1);
+            printf("Please ensure each process's PID is unique.\n");
+            return FALSE;
+        }
+        table->pid_indexes[initial.pid] = i + 1;
+    }
+
+    // Sort the processes by arrival time (a counting sort, which keeps processes arriving at the same time in the order read in)
+    unsigned int *arrivals_before = calloc(TIMEOUT + 1, sizeof(unsigned int));
+    if (!arrivals_before) {
+        printf("Unable to allocate memory for %u processes!\n", table->num_processes);
+        return FALSE;
+    }
+    for (unsigned int i = 0; i < table->num_processes; i++) {
+        arrivals_before[table->processes[i].arrival_time + 1]++;
+    }
+    for (int time = 1; time <= TIMEOUT; time++) {
+        arrivals_before[time] += arrivals_before[time - 1];
+    }
+    for (unsigned int i = 0; i < table->num_processes; i++) {
+        table->arrival_order[arrivals_before[table->processes[i].arrival_time]++] = i;
+    }
+    free(arrivals_before);
+    return TRUE;
+}
+
+/*
+ * Reads in a checkpoint saved by save_checkpoint, setting up the simulation to resume from it.
+ * parameters:
+ *   filename - the checkpoint file to read
+ *   table - where to store the processes being simulated
+ *   sim - the simulation to set up
+ *   scheduler - the scheduling algorithm's functions (its state is read in with its load_scheduler_state)
+ * returns:
+ *   TRUE if the checkpoint was read in successfully, FALSE otherwise (after printing an error message)
+ */
+bool load_checkpoint(const char *filename, process_table *table, simulation *sim, scheduler_module scheduler) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        printf("Unable to read %s!\n", filename);
+        return FALSE;
+    }
+
+    // Read in and check the processes
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    unsigned int num_processes;
+    bool has_magic = fread(magic, sizeof(magic), 1, fp) == 1;
+    if (has_magic && memcmp(magic, STREAM_CHECKPOINT_MAGIC, sizeof(magic)) == 0) {
+        printf("%s is a checkpoint of a streaming simulation!\n", filename);
+        printf("Please resume it with --stream.\n");
+        fclose(fp);
+        return FALSE;
+    }
+    if (!has_magic || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+        fread(&num_processes, sizeof(unsigned int), 1, fp) != 1 || num_processes < 1 || num_processes >= TIMEOUT) {
+        printf("%s is not a valid checkpoint!\n", filename);
+        fclose(fp);
+        return FALSE;
+    }
+    if (!allocate_process_table(table, num_processes)) {
+        fclose(fp);
+        return FALSE;
+    }
+    if (fread(table->processes, sizeof(process_initial), num_processes, fp) != num_processes) {
+        printf("%s is not a valid checkpoint!\n", filename);
+        fclose(fp);
+        return FALSE;
+    }
+    if (!validate_processes(table)) {
+        fclose(fp);
+        return FALSE;
+    }
+
+    // Read in the simulation's progress, then the scheduling algorithm's state
+    if (!init_simulation(sim, "scheduler", scheduler, table)) {
+        printf("Unable to allocate memory for %u processes!\n", num_processes);
+        fclose(fp);
+        return FALSE;
+    }
+    long output_offset;
+    bool valid = fread(&sim->time, sizeof(unsigned int), 1, fp) == 1 &&
+        fread(&sim->num_remaining, sizeof(unsigned int), 1, fp) == 1 &&
+        fread(&sim->next_arrival, sizeof(unsigned int), 1, fp) == 1 &&
+        fread(&output_offset, sizeof(long), 1, fp) == 1 &&
+        sim->num_remaining <= num_processes && sim->next_arrival <= num_processes;
+    for (unsigned int i = 0; valid && i < num_processes; i++) {
+      unsigned int progress[2];
+      valid = fread(progress, sizeof(progress), 1, fp) == 1;
+      sim->processes[i].processed_time = progress[0];
+      sim->processes[i].end_time = progress[1];
+    }
+    valid = valid && scheduler.load_scheduler_state(fp);
+    fclose(fp);
+    if (!valid) {
+        printf("%s is not a valid checkpoint!\n", filename);
+        return FALSE;
+    }
+
+    restore_output(output_offset);
+    return TRUE;
+}
+
+/*
+ * Loads a scheduling algorithm built as a module with module.c.
+ * parameters:
+ *   path - the path of the module to load
+ *   scheduler - where to store the algorithm's functions
+ * returns:
+ *   TRUE if the module was loaded, FALSE otherwise
+ */
+bool load_module(const char *path, scheduler_module *scheduler) {
+    // Ensure a path without a directory is loaded from the current directory, rather than the library path
+    char local_path[strlen(path) + 3];
+    if (!strchr(path, '/')) {
+      snprintf(local_path, sizeof(local_path), "./%s", path);
+      path = local_path;
+    }
+
+    // Load a separate copy of the module (which fails if it is already loaded), so it has its own global variables
+    void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL | RTLD_NOLOAD);
+    if (handle) {
+      printf("Module %s can only be loaded once!\n", path);
+      dlclose(handle);
+      return FALSE;
+    }
+    handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+      printf("Unable to load module %s: %s\n", path, dlerror());
+      return FALSE;
+    }
+    const scheduler_module *exported = dlsym(handle, SCHEDULER_MODULE_SYMBOL);
+    if (!exported) {
+      printf("Module %s does not export a scheduler (was it built with module.c?)\n", path);
+      dlclose(handle);
+      return FALSE;
+    }
+    *scheduler = *exported;
+    return TRUE;
+}
+
+/*
+ * Determines the name of the algorithm in the given module, which is the module's file name without its extension.
+ * parameters:
+ *   path - the path of the module
+ * returns:
+ *   The name of the algorithm (which must be freed)
+ */
+char *module_name(const char *path) {
+    const char *base = strrchr(path, '/');
+    char *name = strdup(base ? base + 1 : path);
+    char *extension = strrchr(name, '.');
+    if (extension && extension != name) {
+      *extension = '\0';
+    }
+    return name;
+}
+
+/* The largest number of parameters that are checked to have been read by the scheduling algorithm */
+#define MAX_CHECKED_PARAMETERS 64
+
+/* The parameters set with -p (as NAME=VALUE), and whether the compiled in scheduling algorithm has read each one */
+const char *checked_parameters[MAX_CHECKED_PARAMETERS];
+bool checked_parameters_read[MAX_CHECKED_PARAMETERS];
+unsigned int num_checked_parameters = 0;
+
+/*
+ * Sets a tunable parameter of the scheduling algorithm (see scheduler_parameter in scheduler.h).
+ * parameters:
+ *   assignment - the parameter to set, in the form NAME=VALUE
+ * returns:
+ *   TRUE if the parameter was set, FALSE if the assignment is invalid
+ */
+bool set_scheduler_parameter(const char *assignment) {
+  const char *value = strchr(assignment, '=');
+  if (!value || value == assignment || value - assignment > MAX_LINE_LENGTH) {
+    return FALSE;
+  }
+  char variable[MAX_LINE_LENGTH + sizeof("SCHEDULER_")];
+  snprintf(variable, sizeof(variable), "SCHEDULER_%.*s", (int) (value - assignment), assignment);
+  if (num_checked_parameters < MAX_CHECKED_PARAMETERS) {
+    checked_parameters[num_checked_parameters++] = assignment;
+  }
+  return setenv(variable, value + 1, 1) == 0;
+}
+
+/*
+ * Records that the compiled in scheduling algorithm has read the parameter with the given name (see
+ * scheduler_parameter_read in scheduler.h).
+ * parameters:
+ *   name - the name of the parameter
+ */
+void scheduler_parameter_read(const char *name) {
+  size_t length = strlen(name);
+  for (unsigned int i = 0; i < num_checked_parameters; i++) {
+    if (strncmp(checked_parameters[i], name, length) == 0 && checked_parameters[i][length] == '=') {
+      checked_parameters_read[i] = TRUE;
+    }
+  }
+}
+
+/*
+ * Warns about each parameter set with -p that the compiled in scheduling algorithm never read, as it had no effect
+ * (most likely because its name is misspelt).
+ */
+void warn_unread_parameters() {
+  for (unsigned int i = 0; i < num_checked_parameters; i++) {
+    if (!checked_parameters_read[i]) {
+      fprintf(stderr, "Warning: the scheduling algorithm never read the parameter %.*s (is it misspelt?)\n",
+          (int) (strchr(checked_parameters[i], '=') - checked_parameters[i]), checked_parameters[i]);
+    }
+  }
+}
+
+/* The largest request the simulator service accepts from a client (its working directory, algorithm and arguments) */
+#define MAX_REQUEST_LENGTH 65536
+
+/* A scheduling algorithm the simulator service can run, by name */
+typedef struct service_algorithm {
+    char *name;  // the name clients give for the algorithm
+    scheduler_module scheduler;  // the algorithm's functions
+} service_algorithm;
+
+/* A job being run by one of the simulator service's workers */
+typedef struct service_job {
+    int connection;  // the client's connection (-1 if this worker is free)
+    pid_t pid;  // the process running the job (negated once it has been killed, or 0 if this worker is free)
+} service_job;
+
+/* Runs the simulator with the given arguments (defined below, as it also starts the simulator service) */
+int run_simulator(int argc, char *argv[], const scheduler_module *job_scheduler);
+
+/* The write end of the pipe that wakes up the simulator service when a worker finishes or it is asked to stop */
+int service_wakeup = -1;
+
+/* Whether the simulator service has been asked to stop */
+volatile sig_atomic_t service_stopping = 0;
+
+/*
+ * Wakes up the simulator service when a worker finishes, or it is asked to stop.
+ * parameters:
+ *   sig - the signal received
+ */
+void wake_service(int sig) {
+    int saved_errno = errno;
+    if (sig != SIGCHLD) {
+      service_stopping = 1;
+    }
+    if (write(service_wakeup, "", 1) < 0) {
+      // (the pipe is full, so the service will wake up anyway)
+    }
+    errno = saved_errno;
+}
+
+/*
+ * Receives a job from a client, and starts a worker to run it. The request is a single message containing
+ * the client's working directory, the name of the algorithm and the arguments to run the simulator with, each
+ * terminated by a NUL, along with the files to use as the job's standard output and standard error (e.g., the
+ * client's own, so the worker's output goes exactly where the client's would have). The worker is a fork of the
+ * service, so each job starts with a fresh copy of the algorithm's global variables (however many jobs have
+ * already run it), and a job that crashes doesn't affect the service.
+ * parameters:
+ *   connection - the client's connection
+ *   algorithms - the algorithms the service can run
+ *   num_algorithms - the number of algorithms
+ *   listener - the service's socket (which the worker doesn't need)
+ * returns:
+ *   The process running the job, or 0 if the request was invalid (in which case the client has been told)
+ */
+pid_t start_job(int connection, service_algorithm algorithms[], unsigned int num_algorithms, int listener) {
+    static char request[MAX_REQUEST_LENGTH];
+    char control[CMSG_SPACE(2 * sizeof(int))];
+    struct iovec iov = {request, sizeof(request) - 1};
+    struct msghdr message = {NULL, 0, &iov, 1, control, sizeof(control), 0};
+    ssize_t length = recvmsg(connection, &message, 0);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+    int status = 1;
+    if (length <= 0 || !cmsg || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(2 * sizeof(int))) {
+      if (cmsg && cmsg->cmsg_type == SCM_RIGHTS) {
+        int *fds = (int *) CMSG_DATA(cmsg);
+        for (size_t i = 0; i < (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int); i++) {
+          close(fds[i]);
+        }
+      }
+      send(connection, &status, sizeof(status), MSG_NOSIGNAL);
+      return 0;
+    }
+    int fds[2];
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    request[length] = '\0';
+
+    // Split the request in to its strings
+    char *strings[MAX_REQUEST_LENGTH / 2 + 2];
+    int num_strings = 0;
+    for (char *s = request; s < request + length; s += strlen(s) + 1) {
+      strings[num_strings++] = s;
+    }
+    scheduler_module *scheduler = NULL;
+    for (unsigned int i = 0; num_strings >= 2 && i < num_algorithms; i++) {
+      if (strcmp(algorithms[i].name, strings[1]) == 0) {
+        scheduler = &algorithms[i].scheduler;
+      }
+    }
+    pid_t pid = -1;
+    if (scheduler) {
+      fflush(stdout);
+      pid = fork();
+    } else {
+      dprintf(fds[1], "Unknown algorithm %s!\n", num_strings >= 2 ? strings[1] : "");
+    }
+    if (pid == 0) {
+      // Run the job as if the simulator had been started with its arguments, in the client's directory
+      struct sigaction action;
+      memset(&action, 0, sizeof(action));
+      action.sa_handler = SIG_DFL;
+      sigaction(SIGCHLD, &action, NULL);
+      sigaction(SIGTERM, &action, NULL);
+      sigaction(SIGINT, &action, NULL);
+      close(listener);
+      close(connection);
+      if (chdir(strings[0]) != 0 || dup2(fds[0], STDOUT_FILENO) < 0 || dup2(fds[1], STDERR_FILENO) < 0) {
+        _exit(1);
+      }
+      strings[1] = "simulator";
+      strings[num_strings] = NULL;
+      optind = 0;  // (getopt_long has already been used by the service)
+      exit(run_simulator(num_strings - 1, &strings[1], scheduler));
+    }
+    close(fds[0]);
+    close(fds[1]);
+    if (pid < 0) {
+      send(connection, &status, sizeof(status), MSG_NOSIGNAL);
+      return 0;
+    }
+    return pid;
+}
+
+/*
+ * Runs the simulator as a service on a Unix socket, which runs jobs sent by clients (see simulator_client.c) with
+ * any of the given algorithms, in up to the given number of workers at once (further clients wait to be accepted).
+ * Each worker is a fork of the service, with the algorithms already loaded, so a job has none of the cost of
+ * starting a process or loading the algorithm. If a client disconnects (e.g., it is timed out), its job is killed.
+ * Runs until sent SIGTERM or SIGINT.
+ * parameters:
+ *   path - the path of the socket to listen on
+ *   algorithms - the algorithms the service can run
+ *   num_algorithms - the number of algorithms
+ *   num_workers - the number of jobs that can run at once
+ * returns:
+ *   0 once the service is stopped, or 1 if it could not be started
+ */
+int serve(const char *path, service_algorithm algorithms[], unsigned int num_algorithms, unsigned int num_workers) {
+    struct sockaddr_un address = {AF_UNIX, ""};
+    int wakeup[2];
+    if (strlen(path) >= sizeof(address.sun_path) || pipe(wakeup) != 0) {
+      fprintf(stderr, "Unable to listen on %s!\n", path);
+      return 1;
+    }
+    for (int i = 0; i < 2; i++) {
+      fcntl(wakeup[i], F_SETFL, O_NONBLOCK);
+      fcntl(wakeup[i], F_SETFD, FD_CLOEXEC);
+    }
+    strcpy(address.sun_path, path);
+    int listener = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    unlink(path);
+    if (listener < 0 || fcntl(listener, F_SETFD, FD_CLOEXEC) != 0 ||
+        bind(listener, (struct sockaddr *) &address, sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+      fprintf(stderr, "Unable to listen on %s!\n", path);
+      return 1;
+    }
+
+    service_wakeup = wakeup[1];
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = wake_service;
+    action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigaction(SIGCHLD, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGINT, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    service_job jobs[num_workers];
+    struct pollfd fds[num_workers + 2];
+    unsigned int num_running = 0;
+    for (unsigned int i = 0; i < num_workers; i++) {
+      jobs[i].connection = -1;
+      jobs[i].pid = 0;
+    }
+    fprintf(stderr, "Serving %u algorithms on %s with %u workers\n", num_algorithms, path, num_workers);
+    while (!service_stopping || num_running > 0) {
+      // Wait for a worker to finish, a client to disconnect, or (if a worker is free) a new client
+      fds[0] = (struct pollfd) {wakeup[0], POLLIN, 0};
+      fds[1] = (struct pollfd) {listener, num_running < num_workers && !service_stopping ? POLLIN : 0, 0};
+      for (unsigned int i = 0; i < num_workers; i++) {
+        fds[i + 2] = (struct pollfd) {jobs[i].connection, jobs[i].pid > 0 ? POLLIN : 0, 0};
+      }
+      if (poll(fds, num_workers + 2, -1) < 0 && errno != EINTR) {
+        break;
+      }
+
+      if (fds[0].revents) {
+        char buffer[64];
+        while (read(wakeup[0], buffer, sizeof(buffer)) > 0) {
+        }
+        if (service_stopping) {
+          for (unsigned int i = 0; i < num_workers; i++) {
+            if (jobs[i].connection >= 0 && jobs[i].pid > 0) {
+              kill(jobs[i].pid, SIGKILL);
+            }
+          }
+        }
+      }
+
+      // Tell the clients of any workers that have finished how their job exited
+      int status;
+      pid_t pid;
+      while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        for (unsigned int i = 0; i < num_workers; i++) {
+          if (jobs[i].connection >= 0 && (jobs[i].pid == pid || jobs[i].pid == -pid)) {
+            int result = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+            send(jobs[i].connection, &result, sizeof(result), MSG_NOSIGNAL);
+            close(jobs[i].connection);
+            jobs[i].connection = -1;
+            num_running--;
+          }
+        }
+      }
+
+      // Kill the job of any client that has disconnected (a client never sends anything after its request)
+      for (unsigned int i = 0; i < num_workers; i++) {
+        if (fds[i + 2].revents && jobs[i].connection == fds[i + 2].fd && jobs[i].pid > 0) {
+          kill(jobs[i].pid, SIGKILL);
+          jobs[i].pid = -jobs[i].pid;
+        }
+      }
+
+      if (fds[1].revents & POLLIN) {
+        int connection = accept(listener, NULL, NULL);
+        if (connection >= 0) {
+          fcntl(connection, F_SETFD, FD_CLOEXEC);
+        }
+        pid = connection >= 0 ? start_job(connection, algorithms, num_algorithms, listener) : 0;
+        if (pid > 0) {
+          unsigned int i = 0;
+          while (jobs[i].connection >= 0) {
+            i++;
+          }
+          jobs[i].connection = connection;
+          jobs[i].pid = pid;
+          num_running++;
+        } else if (connection >= 0) {
+          close(connection);
+        }
+      }
+    }
+
+    close(listener);
+    unlink(path);
+    return 0;
+}
+
+/*
+ * Prints out usage information fdr the program.
+ * parameters:
+ *   cmd - the command used to start the program
+ *   error - the error message that should be displayed (ignored if NULL)
+ */
+void usage(char *cmd, char *error) {
+  if (error) {
+    printf("Error: %s\n\n", error);
+  }
+
+  printf("Usage: %s [-d] [-q] [-p NAME=VALUE]... [-m MODULE]... [-j THREADS] [--profile] [--summary SUMMARY]\n", cmd);
+  printf("\t[--checkpoint CHECKPOINT [--checkpoint-interval STEPS]] FILE\n");
+  printf("   or: %s [-d] [-q] [-p NAME=VALUE]... [--profile] [--summary SUMMARY]\n", cmd);
+  printf("\t[--checkpoint CHECKPOINT [--checkpoint-interval STEPS]] --stream FILE\n");
+  printf("   or: %s [-d] [-q] [-p NAME=VALUE]... [--profile] [--summary SUMMARY] [--checkpoint-interval STEPS]\n", cmd);
+  printf("\t[--stream] --resume CHECKPOINT\n");
+  printf("   or: %s [-m MODULE]... [-j WORKERS] --serve SOCKET\n", cmd);
+  printf("Where:\n");
+  printf("\t-d\tspecifies that the simulator should execute in debug mode\n");
+  printf("\t-q\tspecifies that only the statistics should be output (along with the 99th percentile turnaround time),\n");
+  printf("\t\tleaving out the process scheduled at each time step\n");
+  printf("\t-p\tsets a tunable parameter of the scheduling algorithm (e.g., -p QUANTUM=4)\n");
+  printf("\t-m\tis a scheduling algorithm built as a module (with module.c) to compare - if any are given, the file is\n");
+  printf("\t\tsimulated by every module in lockstep, and a table comparing their statistics is output instead\n");
+  printf("\t-j\tis the number of threads to spread the modules' simulations over (or, with --serve, the number of\n");
+  printf("\t\tjobs to run at once) (defaults to 1)\n");
+  printf("\t--profile\tspecifies that the time taken by each phase of the simulator (and the hardware events counted\n");
+  printf("\t\taround the simulation and each call to the scheduling algorithm, where possible) should be output\n");
+  printf("\t\tas JSON to standard error\n");
+  printf("\t--checkpoint\tis a file to save the progress of the simulation to periodically, so it can be resumed\n");
+  printf("\t\t(the scheduling algorithm must define save_scheduler_state and load_scheduler_state)\n");
+  printf("\t--checkpoint-interval\tis the number of time steps between checkpoints (defaults to %u)\n",
+      DEFAULT_CHECKPOINT_INTERVAL);
+  printf("\t--resume\tis a checkpoint to resume a simulation from (continuing to save checkpoints to it), which\n");
+  printf("\t\tdiscards any output after the checkpoint if the output is to the same file (a checkpoint of a\n");
+  printf("\t\tstreaming simulation is resumed with --stream, and reopens the schedule where it had read up to)\n");
+  printf("\t--stream\tspecifies that the processes should be read in as they arrive, and their statistics\n");
+  printf("\t\ttotalled as they finish, so memory use is proportional to the number of unfinished processes\n");
+  printf("\t\t(the processes must be in order of arrival time, and there is no limit on their number or times)\n");
+  printf("\t--summary\tis a file to write the statistics of the simulation to, as a single line of JSON (with\n");
+  printf("\t\t\"completed\": false if it failed), for collecting the results of many simulations\n");
+  printf("\t--serve\tis a Unix socket to run the simulator as a service on, which keeps the compiled in algorithm\n");
+  printf("\t\t(as \"scheduler\") and each module loaded, and runs the jobs sent by clients in up to WORKERS\n");
+  printf("\t\tprocesses at once (until it is sent SIGTERM) - jobs are sent with simulator_client.c, naming the\n");
+  printf("\t\talgorithm \"scheduler\", or a module's file name without its extension\n");
+  printf("\tFILE\tis the name of the file to read processes from\n");
+}
+
+/*
+ * Checks the required command line argument (which should be the name of the file to process) is present,
+ * attempts to read in the file, and runs the simulations (or starts the simulator service).
+ * parameters:
+ *   argc - the number of arguments
+ *   argv - the arguments (starting with the command used to start the program)
+ *   job_scheduler - in a worker of the simulator service, the algorithm to run instead of the one compiled in to
+ *     the simulator (NULL otherwise)
+ * returns:
+ *   The program's exit status
+ */
+int run_simulator(int argc, char *argv[], const scheduler_module *job_scheduler) {
+    // Check arguments (long options have values beyond those of any character)
+    enum long_option {OPTION_PROFILE = 256, OPTION_CHECKPOINT, OPTION_CHECKPOINT_INTERVAL, OPTION_RESUME, OPTION_STREAM,
+        OPTION_SUMMARY, OPTION_SERVE};
+    struct option long_options[] = {
+        {"profile", no_argument, NULL, OPTION_PROFILE},
+        {"checkpoint", required_argument, NULL, OPTION_CHECKPOINT},
+        {"checkpoint-interval", required_argument, NULL, OPTION_CHECKPOINT_INTERVAL},
+        {"resume", required_argument, NULL, OPTION_RESUME},
+        {"stream", no_argument, NULL, OPTION_STREAM},
+        {"summary", required_argument, NULL, OPTION_SUMMARY},
+        {"serve", required_argument, NULL, OPTION_SERVE},
+        {NULL, 0, NULL, 0}};
+    bool profiling = FALSE;
+    checkpoint_options checkpoint = {NULL, DEFAULT_CHECKPOINT_INTERVAL};
+    char *resume_filename = NULL;
+    char *filename = NULL;
+    char *modules[argc];
+    unsigned int num_modules = 0;
+    unsigned int num_threads = 1;
+    bool quiet = FALSE;
+    bool streaming = FALSE;
+    char *summary_filename = NULL;
+    char *socket_path = NULL;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "dqp:m:j:", long_options, NULL)) != -1) {
+      switch (opt) {
+        case 'd':
+          debug = TRUE;
+          break;
+        case 'q':
+          quiet = TRUE;
+          break;
+        case 'p':
+          if (!set_scheduler_parameter(optarg)) {
+            usage(argv[0], "Parameters must be given as NAME=VALUE");
+            return -1;
+          }
+          break;
+        case 'm':
+          modules[num_modules++] = optarg;
+          break;
+        case 'j':
+          num_threads = strtoul(optarg, NULL, 10);
+          break;
+        case OPTION_PROFILE:
+          profiling = TRUE;
+          break;
+        case OPTION_CHECKPOINT:
+          checkpoint.filename = optarg;
+          break;
+        case OPTION_CHECKPOINT_INTERVAL:
+          checkpoint.interval = strtoul(optarg, NULL, 10);
+          break;
+        case OPTION_RESUME:
+          resume_filename = optarg;
+          break;
+        case OPTION_STREAM:
+          streaming = TRUE;
+          break;
+        case OPTION_SUMMARY:
+          summary_filename = optarg;
+          break;
+        case OPTION_SERVE:
+          socket_path = optarg;
+          break;
+        default:
+          usage(argv[0], "Invalid command line arguments");
+          return -1;
+      }
+    }
+
+    // The simulator service runs jobs with the compiled in algorithm (as "scheduler") and every module
+    if (socket_path) {
+      if (job_scheduler || optind != argc || num_threads == 0) {
+        usage(argv[0], "Invalid command line arguments");
+        return -1;
+      }
+      service_algorithm algorithms[num_modules + 1];
+      algorithms[0] = (service_algorithm) {"scheduler", {add_to_ready_queue, get_next_scheduled_process,
+          save_scheduler_state, load_scheduler_state}};
+      for (unsigned int i = 0; i < num_modules; i++) {
+        algorithms[i + 1].name = module_name(modules[i]);
+        if (!load_module(modules[i], &algorithms[i + 1].scheduler)) {
+          return 1;
+        }
+      }
+      return serve(socket_path, algorithms, num_modules + 1, num_threads);
+    }
+    if (optind == argc - 1 && num_threads > 0 && !resume_filename) {
+      filename = argv[optind];
+    }
+    if ((!filename && !resume_filename) || (resume_filename && (optind != argc || checkpoint.filename)) ||
+        checkpoint.interval == 0) {
+        usage(argv[0], "Invalid command line arguments");
+        return -1;
+    }
+
+    // A resumed simulation continues to save checkpoints to the checkpoint it was resumed from
+    if (resume_filename) {
+      checkpoint.filename = resume_filename;
+    }
+    if (checkpoint.filename && num_modules > 0) {
+      usage(argv[0], "Checkpoints can only be used when simulating a single algorithm");
+      return -1;
+    }
+    if (streaming && num_modules > 0) {
+      usage(argv[0], "Streaming can't be used with modules");
+      return -1;
+    }
+    if (summary_filename && num_modules > 0) {
+      usage(argv[0], "A summary can only be written when simulating a single algorithm");
+      return -1;
+    }
+    simulation_summary summary = {FALSE, 0, 0, 0, 0, 0, {FALSE, 0, 0, 0}};
+
+    // If profiling, time each phase from here
+    profile storage;
+    profile *prof = NULL;
+    profile_sample phase_start;
+    if (profiling) {
+      prof = &storage;
+      start_profile(prof, &phase_start);
+    }
+
+    // The scheduling algorithm compiled in to the simulator (which is profiled if required)
+    scheduler_module scheduler = {add_to_ready_queue, get_next_scheduled_process,
+        save_scheduler_state, load_scheduler_state};
+    if (job_scheduler) {
+      // (or, in a worker of the simulator service, the algorithm the client asked for)
+      scheduler = *job_scheduler;
+    }
+    if (checkpoint.filename && (!scheduler.save_scheduler_state || !scheduler.load_scheduler_state)) {
+      printf("The scheduling algorithm does not support checkpoints!\n");
+      printf("Please ensure it defines save_scheduler_state and load_scheduler_state (see scheduler.h).\n");
+      return 1;
+    }
+    // Only the compiled in algorithm can record the parameters it reads (checked once it has run a whole simulation)
+    bool check_parameters = scheduler.add_to_ready_queue == add_to_ready_queue && num_modules == 0;
+    if (prof && num_modules == 0) {
+      profile_scheduler(prof, &scheduler);
+    }
+
+    // A streaming simulation reads in the processes as it goes, so it is all one phase
+    if (streaming) {
+      profile_sample simulation_start;
+      if (prof) {
+        take_sample(prof, &simulation_start);
+      }
+      bool completed = run_streaming_simulation(filename, scheduler, quiet, checkpoint.filename ? &checkpoint : NULL,
+          resume_filename, summary_filename ? &summary : NULL);
+      if (check_parameters && completed) {
+        warn_unread_parameters();
+      }
+
+      // The simulation has finished, so its checkpoint is no longer needed
+      if (checkpoint.filename) {
+        remove(checkpoint.filename);
+      }
+      if (summary_filename && !write_summary(summary_filename, &summary)) {
+        fprintf(stderr, "Unable to write the summary to %s!\n", summary_filename);
+      }
+      if (prof) {
+        add_measurement(prof, &prof->simulation, &simulation_start);
+        fflush(stdout);
+        end_phase(prof, PHASE_SIMULATION, &phase_start);
+        close_counters(prof);
+        print_profile(stderr, prof);
+      }
+      return completed ? 0 : 1;
+    }
+
+    // Attempt to read processes (only once, however many algorithms are simulated)
+    process_table table;
+    simulation sim;
+    if (resume_filename) {
+      // Read in the processes and the progress of the simulation (parsing and validating in one phase)
+      if (!load_checkpoint(resume_filename, &table, &sim, scheduler)) {
+        return 1;
+      }
+      end_phase(prof, PHASE_PARSE, &phase_start);
+    } else {
+      if (!read_processes(filename, &table)) {
+        return 1;
+      }
+      end_phase(prof, PHASE_PARSE, &phase_start);
+      if (!validate_processes(&table)) {
+        return 1;
+      }
+      end_phase(prof, PHASE_VALIDATION, &phase_start);
+    }
+
+    if (num_modules == 0) {
+      // Run simulation for 1,000,000 time steps, outputting results if successful
+      if (!resume_filename && !init_simulation(&sim, "scheduler", scheduler, &table)) {
+        printf("Unable to allocate memory for %u processes!\n", table.num_processes);
+        return 1;
+      }
+      profile_sample simulation_start;
+      if (prof) {
+        take_sample(prof, &simulation_start);
+      }
+      bool completed = run_simulation(&sim, &table, TIMEOUT, quiet, checkpoint.filename ? &checkpoint : NULL);
+      if (prof) {
+        add_measurement(prof, &prof->simulation, &simulation_start);
+      }
+      end_phase(prof, PHASE_SIMULATION, &phase_start);
+      if (check_parameters && completed) {
+        warn_unread_parameters();
+      }
+
+      // The simulation has finished, so its checkpoint is no longer needed
+      if (checkpoint.filename) {
+        remove(checkpoint.filename);
+      }
+      if (completed) {
+        print_statistics(sim.processes, table.num_processes);
+        if (quiet) {
+          printf("99th percentile turnaround time:\t%u\n",
+              calculate_percentile_turnaround_time(sim.processes, table.num_processes, 99));
+        }
+      }
+
+      // The summary goes to its own file (and any error to standard error), so the output is unchanged
+      if (summary_filename) {
+        summary.completed = completed;
+        summary.num_processes = table.num_processes;
+        summary.time_steps = sim.time;
+        if (completed) {
+          summary.average_turnaround = calculate_average_turnaround_time(sim.processes, table.num_processes);
+          summary.average_wait = calculate_average_wait_time(sim.processes, table.num_processes);
+          summary.percentile_turnaround = calculate_percentile_turnaround_time(sim.processes, table.num_processes, 99);
+          summary.deadlines = calculate_deadline_stats(sim.processes, table.num_processes);
+        }
+        if (!write_summary(summary_filename, &summary)) {
+          fprintf(stderr, "Unable to write the summary to %s!\n", summary_filename);
+        }
+      }
+    } else {
+      // Run a simulation for each module in lockstep, outputting a comparison of their results
+      simulation sims[num_modules];
+      for (unsigned int i = 0; i < num_modules; i++) {
+        scheduler_module scheduler;
+        if (!load_module(modules[i], &scheduler)) {
+          return 1;
+        }
+        if (!init_simulation(&sims[i], module_name(modules[i]), scheduler, &table)) {
+          printf("Unable to allocate memory for %u processes!\n", table.num_processes);
+          return 1;
+        }
+      }
+      // (The modules' functions aren't profiled, as they may be called from several threads at once)
+      profile_sample simulation_start;
+      if (prof) {
+        take_sample(prof, &simulation_start);
+      }
+      run_simulations(sims, num_modules, &table, TIMEOUT, num_threads);
+      if (prof) {
+        add_measurement(prof, &prof->simulation, &simulation_start);
+      }
+      end_phase(prof, PHASE_SIMULATION, &phase_start);
+      print_comparison(sims, num_modules, &table);
+    }
+
+    // Output the profile (to standard error, so the output is unchanged)
+    if (prof) {
+      fflush(stdout);
+      end_phase(prof, PHASE_STATISTICS, &phase_start);
+      close_counters(prof);
+      print_profile(stderr, prof);
+    }
+    return 0;
+}
+
+/*
+ *  Program entry point.
+ *  Runs the simulator with the command line arguments.
+ */
+int main(int argc, char *argv[]) {
+    return run_simulator(argc, argv, NULL);
 }
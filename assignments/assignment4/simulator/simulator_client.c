@@ -0,0 +1,385 @@
+/*
+ * A client of the simulator service (see the --serve option of the simulator), which runs jobs with the
+ * scheduling algorithms the service has loaded. A job is sent as a single message containing the client's
+ * working directory, the name of the algorithm and the arguments to run the simulator with (each terminated
+ * by a NUL), along with the files to use as the job's standard output and standard error. The service replies
+ * with the job's exit status (an int) once it has finished, and kills the job if the client disconnects first.
+ *
+ * The client is deliberately small (it doesn't need the simulator, pthreads or libdl), and can run a whole
+ * batch of jobs read from standard input, several at a time, so running many small schedules costs a single
+ * process rather than one (or more) for each.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* The largest request the simulator service accepts (its working directory, algorithm and arguments) */
+#define MAX_REQUEST_LENGTH 65536
+
+/* The exit status of a job that timed out (the same as timeout(1)) */
+#define TIMED_OUT 124
+
+/* A job that has been sent to the service, and is waiting for its exit status */
+typedef struct job {
+  int connection;  // the connection the job was sent on (-1 if this slot is free)
+  size_t index;  // the job's position in the batch
+  double deadline;  // the time at which the job is timed out (0 for no timeout)
+} job;
+
+/*
+ * Parses a duration in the same format as timeout(1): a number, optionally followed by s (seconds),
+ * m (minutes), h (hours) or d (days).
+ * parameters:
+ *   text - the duration to parse
+ *   seconds - where to store the duration
+ * returns:
+ *   1 if the duration was valid, 0 otherwise
+ */
+int parse_duration(const char *text, double *seconds) {
+  char *end;
+  double value = strtod(text, &end);
+  double scale = 1;
+  switch (*end) {
+    case '\0': case 's': break;
+    case 'm': scale = 60; break;
+    case 'h': scale = 60 * 60; break;
+    case 'd': scale = 24 * 60 * 60; break;
+    default: return 0;
+  }
+  if (end == text || (*end != '\0' && end[1] != '\0') || value < 0) {
+    return 0;
+  }
+  *seconds = value * scale;
+  return 1;
+}
+
+/*
+ * Returns the current time, in seconds.
+ */
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Sends a job to the service.
+ * parameters:
+ *   path - the path of the service's socket
+ *   argc - the number of strings in the job (the algorithm, then the arguments)
+ *   argv - the algorithm and the arguments to run the simulator with
+ *   out - the file to use as the job's standard output
+ *   err - the file to use as the job's standard error
+ * returns:
+ *   The connection the job was sent on (to receive its exit status from), or -1 if it couldn't be sent
+ */
+int send_job(const char *path, int argc, char *argv[], int out, int err) {
+  // Build the request: the working directory, the algorithm and the arguments, each terminated by a NUL
+  static char request[MAX_REQUEST_LENGTH];
+  if (!getcwd(request, sizeof(request))) {
+    fprintf(stderr, "Unable to determine the working directory!\n");
+    return -1;
+  }
+  size_t length = strlen(request) + 1;
+  for (int i = 0; i < argc; i++) {
+    if (length + strlen(argv[i]) + 1 > sizeof(request)) {
+      fprintf(stderr, "The arguments are too long!\n");
+      return -1;
+    }
+    strcpy(request + length, argv[i]);
+    length += strlen(argv[i]) + 1;
+  }
+
+  struct sockaddr_un address = {AF_UNIX, ""};
+  int connection = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+  if (strlen(path) >= sizeof(address.sun_path) || connection < 0) {
+    fprintf(stderr, "Unable to connect to %s!\n", path);
+    return -1;
+  }
+  fcntl(connection, F_SETFD, FD_CLOEXEC);
+  strcpy(address.sun_path, path);
+  if (connect(connection, (struct sockaddr *) &address, sizeof(address)) != 0) {
+    fprintf(stderr, "Unable to connect to %s!\n", path);
+    close(connection);
+    return -1;
+  }
+
+  // Send the request with the job's standard output and standard error
+  int fds[2] = {out, err};
+  char control[CMSG_SPACE(sizeof(fds))];
+  memset(control, 0, sizeof(control));
+  struct iovec iov = {request, length};
+  struct msghdr message = {NULL, 0, &iov, 1, control, sizeof(control), 0};
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+  if (sendmsg(connection, &message, MSG_NOSIGNAL) < 0) {
+    fprintf(stderr, "Unable to send the job to %s!\n", path);
+    close(connection);
+    return -1;
+  }
+  return connection;
+}
+
+/*
+ * Receives the exit status of a job from the service, and closes its connection.
+ * parameters:
+ *   path - the path of the service's socket (for reporting errors)
+ *   connection - the connection the job was sent on
+ * returns:
+ *   The job's exit status (or 1 if the service failed to run it)
+ */
+int receive_status(const char *path, int connection) {
+  int status;
+  if (recv(connection, &status, sizeof(status), MSG_WAITALL) != sizeof(status)) {
+    fprintf(stderr, "The simulator service at %s failed to run the job!\n", path);
+    status = 1;
+  }
+  close(connection);
+  return status;
+}
+
+/*
+ * Waits for one of the running jobs to finish (or time out), storing its exit status.
+ * parameters:
+ *   path - the path of the service's socket
+ *   running - the jobs that have been sent (with at least one running)
+ *   num_slots - the number of jobs that can be running
+ *   statuses - the exit statuses of the batch's jobs
+ */
+void wait_for_job(const char *path, job running[], unsigned int num_slots, int statuses[]) {
+  struct pollfd fds[num_slots];
+  double first_deadline = 0;
+  for (unsigned int i = 0; i < num_slots; i++) {
+    fds[i] = (struct pollfd) {running[i].connection, POLLIN, 0};
+    if (running[i].connection >= 0 && running[i].deadline > 0 &&
+        (first_deadline == 0 || running[i].deadline < first_deadline)) {
+      first_deadline = running[i].deadline;
+    }
+  }
+  int wait_ms = -1;
+  if (first_deadline > 0) {
+    double remaining = first_deadline - now();
+    wait_ms = remaining > 0 ? (int) (remaining * 1000) + 1 : 0;
+  }
+  if (poll(fds, num_slots, wait_ms) < 0 && errno != EINTR) {
+    perror("poll");
+    exit(1);
+  }
+
+  double time = now();
+  for (unsigned int i = 0; i < num_slots; i++) {
+    if (running[i].connection < 0) {
+      continue;
+    }
+    if (fds[i].revents) {
+      statuses[running[i].index] = receive_status(path, running[i].connection);
+      running[i].connection = -1;
+    } else if (running[i].deadline > 0 && time >= running[i].deadline) {
+      // Disconnecting makes the service kill the job
+      close(running[i].connection);
+      statuses[running[i].index] = TIMED_OUT;
+      running[i].connection = -1;
+    }
+  }
+}
+
+/*
+ * Splits a line of a batch into its fields (separated by tabs), in place.
+ * parameters:
+ *   line - the line (without its new line)
+ *   fields - where to store the fields (which must have room for one per character, plus a NULL)
+ * returns:
+ *   The number of fields
+ */
+int split_fields(char *line, char *fields[]) {
+  int count = 0;
+  fields[count++] = line;
+  for (char *c = line; *c; c++) {
+    if (*c == '\t') {
+      *c = '\0';
+      fields[count++] = c + 1;
+    }
+  }
+  fields[count] = NULL;
+  return count;
+}
+
+/*
+ * Runs the batch of jobs on standard input (one per line: the algorithm, the file to write the job's output
+ * to and the arguments to run the simulator with, separated by tabs), with up to the given number running at
+ * once, then writes the exit status of each job to standard output, in order.
+ * parameters:
+ *   path - the path of the service's socket
+ *   num_slots - the number of jobs to run at once
+ *   timeout - the time each job may take, in seconds (0 for no limit)
+ * returns:
+ *   0 if the batch was run (whether or not its jobs succeeded), 1 otherwise
+ */
+int run_batch(const char *path, unsigned int num_slots, double timeout) {
+  int null = open("/dev/null", O_WRONLY | O_CLOEXEC);
+  if (null < 0) {
+    fprintf(stderr, "Unable to open /dev/null!\n");
+    return 1;
+  }
+  job running[num_slots];
+  unsigned int num_running = 0;
+  for (unsigned int i = 0; i < num_slots; i++) {
+    running[i].connection = -1;
+  }
+  int *statuses = NULL;
+  size_t num_jobs = 0;
+  size_t capacity = 0;
+
+  char *line = NULL;
+  size_t line_capacity = 0;
+  ssize_t length;
+  while ((length = getline(&line, &line_capacity, stdin)) >= 0 || num_running > 0) {
+    if (length >= 0) {
+      if (length > 0 && line[length - 1] == '\n') {
+        line[--length] = '\0';
+      }
+      if (num_jobs == capacity) {
+        capacity = capacity ? capacity * 2 : 1024;
+        statuses = realloc(statuses, capacity * sizeof(int));
+        if (!statuses) {
+          fprintf(stderr, "Unable to allocate memory for %zu jobs!\n", capacity);
+          return 1;
+        }
+      }
+
+      // Send the job (with its output going to the given file, and its errors discarded)
+      char *fields[length + 2];
+      int num_fields = split_fields(line, fields);
+      int connection = -1;
+      int out = num_fields >= 3 ? open(fields[1], O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : -1;
+      if (out >= 0) {
+        fields[1] = fields[0];
+        connection = send_job(path, num_fields - 1, &fields[1], out, null);
+        close(out);
+      } else {
+        fprintf(stderr, "Invalid job: %s\n", line);
+      }
+      statuses[num_jobs] = 1;
+      if (connection >= 0) {
+        unsigned int i = 0;
+        while (running[i].connection >= 0) {
+          i++;
+        }
+        running[i] = (job) {connection, num_jobs, timeout > 0 ? now() + timeout : 0};
+        num_running++;
+      }
+      num_jobs++;
+    }
+
+    // Wait for a job to finish if every slot is taken (or there are no more jobs to send)
+    while (num_running > 0 && (num_running == num_slots || length < 0)) {
+      wait_for_job(path, running, num_slots, statuses);
+      num_running = 0;
+      for (unsigned int i = 0; i < num_slots; i++) {
+        num_running += running[i].connection >= 0;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_jobs; i++) {
+    printf("%d\n", statuses[i]);
+  }
+  free(line);
+  free(statuses);
+  close(null);
+  return 0;
+}
+
+/*
+ * Prints out usage information for the program.
+ * parameters:
+ *   cmd - the command the program was started with
+ *   error - an error message to print out first, or NULL
+ */
+void usage(char *cmd, char *error) {
+  if (error) {
+    fprintf(stderr, "Error: %s\n\n", error);
+  }
+
+  fprintf(stderr, "Usage: %s [-t DURATION] SOCKET ALGORITHM [OPTION]... FILE\n", cmd);
+  fprintf(stderr, "   or: %s [-j JOBS] [-t DURATION] SOCKET < BATCH\n", cmd);
+  fprintf(stderr, "Where:\n");
+  fprintf(stderr, "\t-j, --jobs JOBS\t\tthe number of jobs in the batch to run at once (defaults to 1)\n");
+  fprintf(stderr, "\t-t, --timeout DURATION\tthe time each job may take, as for timeout(1), e.g. 30s or 1m (a job that\n"
+      "\t\t\t\ttakes longer is killed, with a status of %d) (defaults to no limit)\n", TIMED_OUT);
+  fprintf(stderr, "\tSOCKET\t\t\tthe socket the simulator service is listening on\n");
+  fprintf(stderr, "\tALGORITHM\t\tthe algorithm to run the simulator with the given options and FILE, as if it were\n"
+      "\t\t\t\tthis process (which exits with the job's status)\n");
+  fprintf(stderr, "\tBATCH\t\t\tjobs to run, one per line: the algorithm, the file to write the output to, then the\n"
+      "\t\t\t\tsimulator's options and FILE, separated by tabs (the status of each job is written\n"
+      "\t\t\t\tto standard output, a line each, once they have all finished)\n");
+}
+
+/*
+ *  Program entry point.
+ *  Runs a single job with the service, or the batch of jobs on standard input.
+ */
+int main(int argc, char *argv[]) {
+  unsigned int num_slots = 1;
+  double timeout = 0;
+
+  static struct option long_options[] = {
+    {"jobs", required_argument, NULL, 'j'},
+    {"timeout", required_argument, NULL, 't'},
+    {NULL, 0, NULL, 0}
+  };
+  int opt;
+  // (+ stops at the algorithm, so the simulator's options aren't parsed)
+  while ((opt = getopt_long(argc, argv, "+j:t:", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'j':
+        num_slots = strtoul(optarg, NULL, 10);
+        if (num_slots == 0) {
+          usage(argv[0], "The number of jobs must be a positive integer");
+          return -1;
+        }
+        break;
+      case 't':
+        if (!parse_duration(optarg, &timeout)) {
+          usage(argv[0], "Durations must be numbers (with an optional s, m, h or d)");
+          return -1;
+        }
+        break;
+      default:
+        usage(argv[0], "Invalid command line arguments");
+        return -1;
+    }
+  }
+  if (optind == argc || argc - optind == 2) {
+    usage(argv[0], "A socket (and either a batch, or an algorithm and the simulator's arguments) must be given");
+    return -1;
+  }
+  const char *path = argv[optind];
+  if (argc - optind == 1) {
+    return run_batch(path, num_slots, timeout);
+  }
+
+  // Run a single job, with this process's output
+  job running[1] = {{send_job(path, argc - optind - 1, &argv[optind + 1], STDOUT_FILENO, STDERR_FILENO), 0,
+      timeout > 0 ? now() + timeout : 0}};
+  if (running[0].connection < 0) {
+    return 1;
+  }
+  int status;
+  while (running[0].connection >= 0) {
+    wait_for_job(path, running, 1, &status);
+  }
+  return status;
+}
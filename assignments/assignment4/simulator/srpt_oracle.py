@@ -0,0 +1,127 @@
+import csv
+import heapq
+import os
+import sys
+
+
+usage = """Computes the optimal average turnaround time for each schedule, using preemptive single-CPU SRPT (Shortest Remaining Processing Time).
+
+Usage: python3 {} [-c FILE] SCHEDULE...
+Where:
+  -c FILE    is a CSV that contains Submission,Schedule,Average, to which Optimal and Gap columns are added
+             (Gap is how far Average is above Optimal, as a fraction of Optimal)
+  SCHEDULE   is a schedule file (or a directory of schedule files) to compute the optimal average for
+
+Without -c, a CSV with columns Schedule,Optimal is written to standard output.
+"""
+
+
+def read_schedule(file):
+    """Reads the given schedule file, returning a list of (arrival_time, processing_time, pid) tuples"""
+    with open(file) as schedule:
+        num_processes = int(schedule.readline())
+        processes = []
+        for _ in range(num_processes):
+            fields = schedule.readline().split(',')
+            processes.append((int(fields[1]), int(fields[2]), int(fields[0])))
+    return processes
+
+
+def optimal_average_turnaround(processes):
+    """
+    Determines the average turnaround time of the given processes under SRPT, which is optimal for a single
+    preemptive CPU. Rather than stepping through each time unit, the simulation jumps between events (an arrival
+    or the running process completing), so it takes O(n log n) time.
+    """
+    if not processes:
+        return 0.0
+    processes = sorted(processes)
+    ready = []  # heap of (remaining_time, pid, arrival_time)
+    total_turnaround = 0
+    time = 0
+    i = 0
+    while i < len(processes) or ready:
+        # Jump to the next arrival if nothing is ready
+        if not ready and time < processes[i][0]:
+            time = processes[i][0]
+
+        # Add all processes that have arrived by now
+        while i < len(processes) and processes[i][0] <= time:
+            arrival_time, processing_time, pid = processes[i]
+            heapq.heappush(ready, (processing_time, pid, arrival_time))
+            i += 1
+
+        # Run the process with the least remaining time until it finishes or the next process arrives
+        remaining_time, pid, arrival_time = ready[0]
+        next_arrival = processes[i][0] if i < len(processes) else None
+        if next_arrival is None or time + remaining_time <= next_arrival:
+            heapq.heappop(ready)
+            time += remaining_time
+            total_turnaround += time - arrival_time
+        else:
+            heapq.heapreplace(ready, (remaining_time - (next_arrival - time), pid, arrival_time))
+            time = next_arrival
+    return total_turnaround / len(processes)
+
+
+def schedule_files(paths):
+    """Expands the given paths (schedule files or directories of schedule files) to a list of schedule files"""
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            files.extend(os.path.join(path, name) for name in sorted(os.listdir(path)) if not name.startswith('.'))
+        else:
+            files.append(path)
+    return files
+
+
+def annotate(file, optimal):
+    """Adds Optimal and Gap columns to the given competition CSV, using the optimal average for each schedule"""
+    with open(file) as csv_file:
+        reader = csv.DictReader(csv_file)
+        fieldnames = [name for name in reader.fieldnames if name not in ('Optimal', 'Gap')] + ['Optimal', 'Gap']
+        rows = list(reader)
+
+    with open(file, 'w', newline='') as csv_file:
+        writer = csv.DictWriter(csv_file, fieldnames, lineterminator='\n')
+        writer.writeheader()
+        for row in rows:
+            best = optimal.get(row['Schedule'])
+            row['Optimal'] = 'NULL' if best is None else f'{best:.2f}'
+            # Ensure any invalid averages have a NULL gap
+            try:
+                row['Gap'] = f'{float(row["Average"]) / best - 1:.4f}'
+            except (TypeError, ValueError, ZeroDivisionError):
+                row['Gap'] = 'NULL'
+            writer.writerow(row)
+
+
+def main(paths, competition_file=None):
+    """Computes the optimal average turnaround for each schedule, either annotating competition_file or printing them"""
+    optimal = {}
+    for file in schedule_files(paths):
+        try:
+            optimal[os.path.basename(file)] = optimal_average_turnaround(read_schedule(file))
+        except (OSError, ValueError, IndexError):
+            print(f'Unable to read schedule {file}', file=sys.stderr)
+
+    if competition_file:
+        annotate(competition_file, optimal)
+    else:
+        print('Schedule,Optimal')
+        for schedule, best in optimal.items():
+            print(f'{schedule},{best:.2f}')
+
+
+if __name__ == "__main__":
+    # Process arguments
+    args = sys.argv[1:]
+    competition_file = None
+    if len(args) >= 2 and args[0] == '-c':
+        competition_file = args[1]
+        args = args[2:]
+    if not args or args[0].startswith('-'):
+        print(usage.format(sys.argv[0]))
+        sys.exit(1)
+
+    main(args, competition_file)
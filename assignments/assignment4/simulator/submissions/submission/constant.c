@@ -19,12 +19,29 @@ typedef struct constant_process {
 
 #define NUM_PRIORITY_QUEUES 4
 
-// The quantum for each priority level
+// The default quantum for each priority level
 #define QUANTUM 3
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
+/* The tunable quantum, read in when the first process is added */
+unsigned int quantum = QUANTUM;
+bool parameters_read = FALSE;
+
+/*
+ * Reads in the tunable parameters (see scheduler_parameter in scheduler.h),
+ * the first time it is called, falling back to the defaults above.
+ */
+void read_parameters() {
+  if (parameters_read) {
+    return;
+  }
+  double value = scheduler_parameter("QUANTUM", QUANTUM);
+  quantum = MAX(1, value);
+  parameters_read = TRUE;
+}
+
 /* Priority queues */
 constant_process priority_queues[NUM_PRIORITY_QUEUES] = {{0, 0, 0, 0, 0, NULL},
                                                          {0, 0, 0, 0, 0, NULL},
@@ -84,6 +101,8 @@ constant_process *remove_next(constant_process *node) {
  *   process - the process to add to the ready queue
  */
 void add_to_ready_queue(const process_initial process) {
+  read_parameters();
+
   // Construct the new constant_process
   constant_process *new_process = malloc(sizeof(constant_process));
   new_process->pid = process.pid;
@@ -128,8 +147,8 @@ void add_to_ready_queue(const process_initial process) {
 /*
  * Determines the next process to the scheduled.
  * Implements a multi-level feedback queue with 4 priority levels.
- * Each priority level has a quantum of 3 units of time determined by the
- * QUANTUM constant. 3k units of time are given to the each process in the kth
+ * Each priority level has a quantum of 3 units of time by default (the QUANTUM
+ * parameter). 3k units of time are given to the each process in the kth
  * priority level before moving to the next priority level.
  *
  *  returns:
@@ -177,7 +196,7 @@ unsigned int get_next_scheduled_process() {
   }
 
   // If the process has used up its quantum, move it to the next priority queue
-  if (current->quantum_used == QUANTUM * (priority_level + 1)) {
+  if (current->quantum_used == quantum * (priority_level + 1)) {
     // Determine the new priority level
     unsigned int new_priority_level =
         MIN(priority_level + 1, NUM_PRIORITY_QUEUES - 1);
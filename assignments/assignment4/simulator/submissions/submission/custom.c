@@ -14,6 +14,35 @@
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
+// Default weights of the remaining time and reschedule penalty in the score
+#define REMAINING_TIME_WEIGHT 1.2
+#define RESCHEDULE_WEIGHT 0.5
+
+// Default quantum scale, giving a quantum of QUANTUM_SCALE * (priority_level + 1)
+#define QUANTUM_SCALE 2
+
+/* The tunable parameters, read in when the first process is added */
+double remaining_time_weight = REMAINING_TIME_WEIGHT;
+double reschedule_weight = RESCHEDULE_WEIGHT;
+unsigned int quantum_scale = QUANTUM_SCALE;
+bool parameters_read = FALSE;
+
+/*
+ * Reads in the tunable parameters (see scheduler_parameter in scheduler.h),
+ * the first time it is called, falling back to the defaults above.
+ */
+void read_parameters() {
+  if (parameters_read) {
+    return;
+  }
+  remaining_time_weight =
+      scheduler_parameter("REMAINING_TIME_WEIGHT", REMAINING_TIME_WEIGHT);
+  reschedule_weight = scheduler_parameter("RESCHEDULE_WEIGHT", RESCHEDULE_WEIGHT);
+  double scale = scheduler_parameter("QUANTUM_SCALE", QUANTUM_SCALE);
+  quantum_scale = MAX(1, scale);
+  parameters_read = TRUE;
+}
+
 /* The process details we're interested in */
 typedef struct custom_process {
   unsigned int pid;
@@ -117,9 +146,6 @@ void free_process_history(unsigned int pid) {
   }
 }
 
-#define REMAINING_TIME_WEIGHT 1.2
-#define RESCHEDULE_WEIGHT 0.5
-
 // Function to calculate a process score based on its history
 double calculate_new_score(process_history *history,
                            custom_process *process) {
@@ -138,8 +164,8 @@ double calculate_new_score(process_history *history,
 
   // Score formula (higher is better)
   history->score = (waiting_factor / running_factor) +
-                   (remaining_time_factor * REMAINING_TIME_WEIGHT) -
-                   (reschedule_penalty * RESCHEDULE_WEIGHT);
+                   (remaining_time_factor * remaining_time_weight) -
+                   (reschedule_penalty * reschedule_weight);
   return history->score;
 }
 
@@ -193,6 +219,8 @@ custom_process *remove_next(custom_process *node) {
  *   process - the process to add to the ready queue
  */
 void add_to_ready_queue(const process_initial process) {
+  read_parameters();
+
   // Construct the new custom_process
   custom_process *new_process = malloc(sizeof(custom_process));
   if (!new_process) {
@@ -376,7 +404,7 @@ unsigned int get_next_scheduled_process() {
 
   // Move process to Smart Queue (Q2) if quantum exceeded
   if (current->quantum_used >=
-      (priority_level + 1) * 2) { // Quantum of 2 for Q1, 4 for Q2
+      (priority_level + 1) * quantum_scale) { // By default 2 for Q1, 4 for Q2
     move_to_smart_queue(current);
     history->reschedule_count++;
     current->quantum_used = 0;
@@ -17,6 +17,7 @@ typedef struct exponential_process {
   struct exponential_process *next_process;
 } exponential_process;
 
+// The default number of priority levels
 #define NUM_PRIORITY_QUEUES 4
 
 // The quantum for each priority level
@@ -24,11 +25,26 @@ typedef struct exponential_process {
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
-/* Priotity queues */
-exponential_process priority_queues[NUM_PRIORITY_QUEUES] = {{0, 0, 0, 0, 0, NULL},
-                                                         {0, 0, 0, 0, 0, NULL},
-                                                         {0, 0, 0, 0, 0, NULL},
-                                                         {0, 0, 0, 0, 0, NULL}};
+/* Priotity queues (num_priority_queues of them, allocated when the first process is added) */
+exponential_process *priority_queues = NULL;
+unsigned int num_priority_queues = NUM_PRIORITY_QUEUES;
+
+/*
+ * Reads in the tunable number of priority levels (see scheduler_parameter in
+ * scheduler.h) and allocates the priority queues, the first time it is called.
+ */
+void read_parameters() {
+  if (priority_queues) {
+    return;
+  }
+  double levels = scheduler_parameter("NUM_PRIORITY_QUEUES", NUM_PRIORITY_QUEUES);
+  num_priority_queues = MAX(1, levels);
+  priority_queues = calloc(num_priority_queues, sizeof(exponential_process));
+  if (!priority_queues) {
+    perror("Failed to allocate memory for priority queues");
+    exit(1);
+  }
+}
 
 // Global variable to keep track of the current process
 exponential_process *current = NULL;
@@ -83,6 +99,8 @@ exponential_process *remove_next(exponential_process *node) {
  *   process - the process to add to the ready queue
  */
 void add_to_ready_queue(const process_initial process) {
+  read_parameters();
+
   // Construct the new exponential_process
   exponential_process *new_process = malloc(sizeof(exponential_process));
   new_process->pid = process.pid;
@@ -117,7 +135,7 @@ void add_to_ready_queue(const process_initial process) {
     }
     printf("Process list after process with pid %d has been added:\n",
            new_process->pid);
-    for (int i = 0; i < NUM_PRIORITY_QUEUES; i++) {
+    for (unsigned int i = 0; i < num_priority_queues; i++) {
       printf("- Priority queue %d:\n", i);
       print_list(&priority_queues[i]);
     }
@@ -126,7 +144,8 @@ void add_to_ready_queue(const process_initial process) {
 
 /*
  * Determines the next process to the scheduled.
- * Implements a multi-level feedback queue with 4 priority levels.
+ * Implements a multi-level feedback queue with 4 priority levels by default
+ * (the NUM_PRIORITY_QUEUES parameter).
  * Each process is given a quantum of 2 * (priority_level + 1)^2
  * If a process uses up its quantum, it is moved to the next priority level
  *  returns:
@@ -135,9 +154,11 @@ void add_to_ready_queue(const process_initial process) {
  */
 
 unsigned int get_next_scheduled_process() {
+  read_parameters();
+
   // Find the next process to schedule
   if (current == NULL) {
-    for (int i = 0; i < NUM_PRIORITY_QUEUES; i++) {
+    for (unsigned int i = 0; i < num_priority_queues; i++) {
       if (priority_queues[i].next_process) {
         current = remove_next(&priority_queues[i]);
         priority_level = i;
@@ -165,7 +186,7 @@ unsigned int get_next_scheduled_process() {
     // If in debug mode, print out the process list after it has changed
     if (debug) {
       printf("Process list after process with pid %d has completed:\n", pid);
-      for (int i = 0; i < NUM_PRIORITY_QUEUES; i++) {
+      for (unsigned int i = 0; i < num_priority_queues; i++) {
         printf("- Priority queue %d:\n", i);
         print_list(&priority_queues[i]);
       }
@@ -178,7 +199,7 @@ unsigned int get_next_scheduled_process() {
       2 * ((priority_level + 1) * (priority_level + 1))) {
     // Determine the new priority level
     unsigned int new_priority_level =
-        MIN(priority_level + 1, NUM_PRIORITY_QUEUES - 1);
+        MIN(priority_level + 1, num_priority_queues - 1);
 
     // Move the process to the new priority level
     exponential_process *end = &priority_queues[new_priority_level];
@@ -0,0 +1,225 @@
+import argparse
+import concurrent.futures
+import csv
+import itertools
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+from srpt_oracle import schedule_files
+
+
+description = """Tunes the parameters of a scheduling algorithm (see scheduler_parameter in scheduler.h) by simulating a corpus of
+schedules with different parameter values, on all cores. Each set of values is scored by the mean (across the schedules)
+of the average turnaround time and of the 99th percentile turnaround time, and the Pareto front of those two scores is
+written to standard output as CSV. If every set of values gives the same results, the parameters had no effect (e.g.,
+their names are misspelt), so the sweep fails instead.
+"""
+
+epilog = """Example:
+  python3 {} -p QUANTUM=1:8 submissions/submission/constant.c schedules
+  python3 {} -s descent -p REMAINING_TIME_WEIGHT=0,0.4,0.8,1.2,1.6 -p QUANTUM_SCALE=1:6 submissions/submission/custom.c schedules
+"""
+
+
+def parse_values(text):
+    """Parses a comma separated list of values, where START:STOP[:STEP] is an inclusive range of numbers"""
+    values = []
+    for item in text.split(','):
+        if item.count(':') in (1, 2):
+            bounds = [float(bound) for bound in item.split(':')]
+            start, stop, step = bounds if len(bounds) == 3 else bounds + [1]
+            if step <= 0:
+                raise ValueError(f'Invalid step in {item}')
+            count = int((stop - start) / step + 1e-9) + 1
+            values.extend(format_value(start + i * step) for i in range(count))
+        else:
+            values.append(format_value(float(item)))
+    return values
+
+
+def format_value(value):
+    """Formats a parameter value, without a trailing .0 for whole numbers"""
+    return str(int(value)) if value == int(value) else f'{value:g}'
+
+
+def parse_parameter(text):
+    """Parses a NAME=VALUES argument, returning (NAME, [values])"""
+    name, _, values = text.partition('=')
+    if not name or not values:
+        raise argparse.ArgumentTypeError(f'{text} is not NAME=VALUES')
+    try:
+        return name, parse_values(values)
+    except ValueError as error:
+        raise argparse.ArgumentTypeError(f'{text} has invalid values ({error})')
+
+
+def build_simulator(algorithm, directory):
+    """Compiles the simulator with the given algorithm as the scheduler in directory, returning its path"""
+    source_dir = os.path.dirname(os.path.abspath(__file__))
+    for file in ('simulator.c', 'scheduler.h'):
+        shutil.copy(os.path.join(source_dir, file), directory)
+    shutil.copy(algorithm, os.path.join(directory, 'scheduler.c'))
+    simulator = os.path.join(directory, 'simulator')
+    subprocess.run(['gcc', '-O2', '-pthread', '-o', simulator, 'simulator.c', '-ldl'], cwd=directory, check=True,
+                   stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    return simulator
+
+
+def simulate(simulator, names, values, schedule):
+    """Simulates the schedule with the given parameter values, returning (average, p99) turnaround, or None on failure"""
+    command = [simulator, '-q']
+    for name, value in zip(names, values):
+        command += ['-p', f'{name}={value}']
+    result = subprocess.run(command + [schedule], stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True)
+    stats = dict(line.split(':\t', 1) for line in result.stdout.splitlines() if ':\t' in line)
+    try:
+        return float(stats['Average turnaround time']), float(stats['99th percentile turnaround time'])
+    except (KeyError, ValueError):
+        return None
+
+
+class Sweep:
+    """Evaluates sets of parameter values across the schedules in parallel, remembering every evaluation"""
+
+    def __init__(self, simulator, names, schedules, executor):
+        self.simulator = simulator
+        self.names = names
+        self.schedules = schedules
+        self.executor = executor
+        self.results = {}  # values -> (mean, p99), or None if any schedule failed
+
+    def evaluate(self, candidates):
+        """Evaluates each of the given tuples of values (that haven't already been evaluated)"""
+        candidates = [values for values in dict.fromkeys(candidates) if values not in self.results]
+        futures = {(values, schedule): self.executor.submit(simulate, self.simulator, self.names, values, schedule)
+                   for values in candidates for schedule in self.schedules}
+        for values in candidates:
+            runs = [futures[(values, schedule)].result() for schedule in self.schedules]
+            if any(run is None for run in runs):
+                self.results[values] = None
+            else:
+                self.results[values] = (sum(run[0] for run in runs) / len(runs),
+                                        sum(run[1] for run in runs) / len(runs))
+            print(f'{describe(self.names, values)}: {describe_result(self.results[values])}', file=sys.stderr)
+
+    def grid(self, value_lists):
+        """Evaluates every combination of the given values"""
+        self.evaluate(itertools.product(*value_lists))
+
+    def descent(self, value_lists, objective, rounds):
+        """
+        Searches for the values that minimise the objective (0 for the mean, 1 for p99) by coordinate descent: starting
+        from the middle value of each parameter, each parameter in turn is set to its best value (with the others
+        fixed), until a round makes no change or the maximum number of rounds is reached.
+        """
+        current = tuple(values[len(values) // 2] for values in value_lists)
+        for _ in range(rounds):
+            changed = False
+            for i, values in enumerate(value_lists):
+                candidates = [current[:i] + (value,) + current[i + 1:] for value in values]
+                self.evaluate(candidates)
+                best = min(candidates, key=lambda candidate: score(self.results[candidate], objective))
+                if score(self.results[best], objective) < score(self.results[current], objective):
+                    current = best
+                    changed = True
+            if not changed:
+                break
+        return current
+
+    def pareto_front(self):
+        """Determines the evaluated values that no others beat on both mean and p99, sorted by mean"""
+        valid = [(values, result) for values, result in self.results.items() if result is not None]
+        front = [(values, result) for values, result in valid
+                 if not any(other[0] <= result[0] and other[1] <= result[1] and other != result for _, other in valid)]
+        return sorted(front, key=lambda item: item[1])
+
+
+def score(result, objective):
+    """Determines the score of an evaluation for the given objective (lower is better, failures are worst)"""
+    return float('inf') if result is None else result[objective]
+
+
+def describe(names, values):
+    """Describes a set of parameter values as NAME=VALUE pairs"""
+    return ' '.join(f'{name}={value}' for name, value in zip(names, values))
+
+
+def describe_result(result):
+    """Describes the result of an evaluation"""
+    return 'failed' if result is None else f'mean {result[0]:.2f}, p99 {result[1]:.2f}'
+
+
+def write_csv(file, names, rows, pareto):
+    """Writes the given (values, result) rows as CSV, with a Pareto column if pareto is not None"""
+    writer = csv.writer(file, lineterminator='\n')
+    writer.writerow(names + ['Mean', 'P99'] + (['Pareto'] if pareto is not None else []))
+    for values, result in rows:
+        row = list(values) + (['NULL', 'NULL'] if result is None else [f'{result[0]:.2f}', f'{result[1]:.2f}'])
+        if pareto is not None:
+            row.append(1 if values in pareto else 0)
+        writer.writerow(row)
+
+
+def main(args):
+    """Runs the sweep described by the command line arguments"""
+    names = [name for name, _ in args.parameter]
+    value_lists = [values for _, values in args.parameter]
+    schedules = schedule_files(args.schedules)
+    if not schedules:
+        print('No schedules found', file=sys.stderr)
+        return 1
+
+    with tempfile.TemporaryDirectory() as directory:
+        try:
+            simulator = build_simulator(args.algorithm, directory)
+        except (OSError, subprocess.CalledProcessError):
+            print(f'Unable to build the simulator with {args.algorithm}', file=sys.stderr)
+            return 1
+
+        with concurrent.futures.ThreadPoolExecutor(args.jobs) as executor:
+            sweep = Sweep(simulator, names, schedules, executor)
+            if args.search == 'grid':
+                sweep.grid(value_lists)
+            else:
+                best = sweep.descent(value_lists, 0 if args.objective == 'mean' else 1, args.rounds)
+                print(f'Best ({args.objective}): {describe(names, best)}: {describe_result(sweep.results[best])}',
+                      file=sys.stderr)
+
+    # A parameter the algorithm never reads is ignored, so identical results most likely mean a misspelt name
+    results = set(sweep.results.values())
+    if len(sweep.results) > 1 and len(results) == 1 and None not in results:
+        print(f'Every set of values gave the same results, so {", ".join(names)} had no effect (please check '
+              f'{args.algorithm} reads {"them" if len(names) > 1 else "it"} with scheduler_parameter)', file=sys.stderr)
+        return 1
+
+    front = sweep.pareto_front()
+    if args.output:
+        with open(args.output, 'w', newline='') as output:
+            write_csv(output, names, sweep.results.items(), {values for values, _ in front})
+    write_csv(sys.stdout, names, front, None)
+    return 0
+
+
+if __name__ == "__main__":
+    # Process arguments
+    parser = argparse.ArgumentParser(description=description, epilog=epilog.format(sys.argv[0], sys.argv[0]),
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-p', '--parameter', type=parse_parameter, action='append', required=True,
+                        help='a parameter and the values to try, as NAME=VALUE,... where START:STOP[:STEP] is an '
+                             'inclusive range (may be given more than once)')
+    parser.add_argument('-s', '--search', choices=('grid', 'descent'), default='grid',
+                        help='evaluate every combination of values (grid, the default), or search by coordinate '
+                             'descent (descent)')
+    parser.add_argument('--objective', choices=('mean', 'p99'), default='mean',
+                        help='the turnaround time coordinate descent minimises (defaults to mean)')
+    parser.add_argument('--rounds', type=int, default=10,
+                        help='the maximum number of rounds of coordinate descent (defaults to 10)')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                        help='the number of simulations to run at once (defaults to the number of cores)')
+    parser.add_argument('-o', '--output', help='a CSV file to write every evaluation to (with a Pareto column)')
+    parser.add_argument('algorithm', help='the C file that implements the scheduling algorithm')
+    parser.add_argument('schedules', nargs='+', help='the schedule files (or directories of schedule files) to simulate')
+    sys.exit(main(parser.parse_args()))
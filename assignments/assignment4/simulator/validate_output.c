@@ -0,0 +1,474 @@
+/*
+ * A validator for the simulator's output, which checks an output file is consistent with
+ * the schedule it was produced from, without re-running the scheduling algorithm.
+ * Checks that the time steps are in order, that no process runs before it arrives or for
+ * longer than its processing time, that every process completes, and that the statistics
+ * reported match those of the time steps.
+ * Files are mapped in to memory and parsed in a single pass, so validating is limited by
+ * how fast the files can be read rather than by parsing.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// The schedule format (and the booleans used throughout)
+#include "scheduler.h"
+
+/* The largest process id supported by the simulator */
+#define MAX_PID 999999
+
+/* The maximum length of the statistics at the end of an output file */
+#define MAX_STATISTICS_LENGTH 512
+
+/* A process from a schedule, along with its progress through the output */
+typedef struct validated_process {
+  unsigned int pid;
+  unsigned int arrival_time;
+  unsigned int processing_time;
+  unsigned int deadline;
+  unsigned int processed_time;  // the number of time steps the process has run for so far
+  unsigned int end_time;  // the time step the process completed in
+} validated_process;
+
+/* A schedule read in to validate outputs against */
+typedef struct validated_schedule {
+  validated_process *processes;
+  unsigned int num_processes;
+  bool has_deadlines;  // whether any process has a deadline
+} validated_schedule;
+
+/* One more than the index of the process with each PID in the current schedule, or 0 if there is no such process */
+unsigned int pid_indexes[MAX_PID + 1];
+
+/* A file mapped in to memory */
+typedef struct mapped_file {
+  const char *start;
+  const char *end;
+  size_t length;
+} mapped_file;
+
+/*
+ * Maps the given file in to memory for reading from start to end.
+ * parameters:
+ *   filename - the file to map
+ *   file - where to store the mapping
+ * returns:
+ *   TRUE if the file was mapped, FALSE if it couldn't be read (or is empty)
+ */
+bool map_file(const char *filename, mapped_file *file) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    return FALSE;
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 || status.st_size == 0) {
+    close(fd);
+    return FALSE;
+  }
+  file->length = status.st_size;
+  void *start = mmap(NULL, file->length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (start == MAP_FAILED) {
+    return FALSE;
+  }
+  madvise(start, file->length, MADV_SEQUENTIAL);
+  file->start = start;
+  file->end = file->start + file->length;
+  return TRUE;
+}
+
+/*
+ * Removes the mapping of a file mapped by map_file.
+ * parameters:
+ *   file - the file to unmap
+ */
+void unmap_file(mapped_file *file) {
+  munmap((void *) file->start, file->length);
+}
+
+/*
+ * Reads an unsigned integer from the given position, stopping at the first character that isn't a digit.
+ * The caller must ensure the text ends with a character that isn't a digit (e.g., a newline).
+ * parameters:
+ *   p - where to start reading, which is updated to the character after the integer
+ * returns:
+ *   The integer read (0 if there are no digits)
+ */
+static inline unsigned long read_number(const char **p) {
+  const char *s = *p;
+  unsigned long value = 0;
+  unsigned int digit;
+  while ((digit = (unsigned char) *s - '0') < 10) {
+    value = value * 10 + digit;
+    s++;
+  }
+  *p = s;
+  return value;
+}
+
+/*
+ * Reads an optional unsigned integer field from a schedule line, which is empty or preceded by a comma.
+ * parameters:
+ *   p - where to start reading, which is updated to the character after the field
+ *   default_value - the value of the field if it isn't present (or is empty)
+ * returns:
+ *   The value of the field
+ */
+unsigned int read_optional_number(const char **p, unsigned int default_value) {
+  if (**p != ',') {
+    return default_value;
+  }
+  (*p)++;
+  const char *start = *p;
+  unsigned int value = read_number(p);
+  return *p == start ? default_value : value;
+}
+
+/*
+ * Reads in a schedule file, replacing any schedule read in previously.
+ * parameters:
+ *   filename - the schedule file to read
+ *   schedule - where to store the schedule
+ * returns:
+ *   NULL if the schedule was read in, or a description of the problem otherwise
+ */
+const char *read_schedule(const char *filename, validated_schedule *schedule) {
+  // Forget the previous schedule's PIDs
+  for (unsigned int i = 0; i < schedule->num_processes; i++) {
+    pid_indexes[schedule->processes[i].pid] = 0;
+  }
+  schedule->num_processes = 0;
+  schedule->has_deadlines = FALSE;
+
+  mapped_file file;
+  if (!map_file(filename, &file)) {
+    return "unable to read schedule";
+  }
+  const char *error = NULL;
+  const char *p = file.start;
+  if (file.end[-1] != '\n') {
+    error = "schedule does not end with a newline";
+  } else {
+    unsigned long num_processes = read_number(&p);
+    if (*p++ != '\n' || num_processes == 0 || num_processes > MAX_PID) {
+      error = "schedule has an invalid number of processes";
+    } else {
+      validated_process *processes = realloc(schedule->processes, num_processes * sizeof(validated_process));
+      if (!processes) {
+        error = "not enough memory for schedule";
+      } else {
+        schedule->processes = processes;
+      }
+    }
+
+    for (unsigned int i = 0; !error && i < num_processes; i++) {
+      validated_process *process = &schedule->processes[i];
+      if (p >= file.end) {
+        error = "schedule has fewer processes than its first line gives";
+        break;
+      }
+      // Each field is only read if the previous one ended correctly, so reading never passes the final newline
+      unsigned long pid = read_number(&p);
+      bool valid = *p == ',';
+      if (valid) {
+        p++;
+        process->arrival_time = read_number(&p);
+        valid = *p == ',';
+      }
+      if (valid) {
+        p++;
+        process->processing_time = read_number(&p);
+        read_optional_number(&p, 0);  // tickets aren't needed to validate an output
+        process->deadline = read_optional_number(&p, NO_DEADLINE);
+        valid = *p++ == '\n' && pid > 0 && pid <= MAX_PID && process->processing_time > 0;
+      }
+      if (!valid || pid_indexes[pid] != 0) {
+        error = valid ? "schedule has duplicate PIDs" : "schedule has an invalid process line";
+        break;
+      }
+      process->pid = pid;
+      process->processed_time = 0;
+      process->end_time = 0;
+      schedule->has_deadlines |= process->deadline != NO_DEADLINE;
+      pid_indexes[pid] = i + 1;
+      schedule->num_processes = i + 1;
+    }
+  }
+  unmap_file(&file);
+  return error;
+}
+
+/*
+ * Writes out the statistics the simulator outputs for the given schedule, once every process has completed.
+ * parameters:
+ *   schedule - the schedule the time steps were validated against
+ *   buffer - where to write the statistics
+ *   size - the size of the buffer
+ * returns:
+ *   The length of the statistics
+ */
+int format_statistics(const validated_schedule *schedule, char *buffer, size_t size) {
+  unsigned long total_turnaround = 0;
+  unsigned long total_wait = 0;
+  unsigned int deadline_misses = 0;
+  unsigned long total_lateness = 0;
+  unsigned int maximum_lateness = 0;
+  for (unsigned int i = 0; i < schedule->num_processes; i++) {
+    const validated_process *process = &schedule->processes[i];
+    unsigned int turnaround = process->end_time - process->arrival_time + 1;
+    total_turnaround += turnaround;
+    total_wait += turnaround - process->processed_time;
+    if (process->deadline != NO_DEADLINE && process->end_time + 1 > process->deadline) {
+      unsigned int lateness = process->end_time + 1 - process->deadline;
+      deadline_misses++;
+      total_lateness += lateness;
+      maximum_lateness = lateness > maximum_lateness ? lateness : maximum_lateness;
+    }
+  }
+
+  // The averages are the same as the simulator's, which sums them exactly as doubles
+  int length = snprintf(buffer, size, "Average turnaround time:\t%.2f\nAverage wait time:\t%.2f\n",
+      (double) total_turnaround / schedule->num_processes, (double) total_wait / schedule->num_processes);
+  if (schedule->has_deadlines) {
+    length += snprintf(buffer + length, size - length, "Deadline misses:\t%u\nTotal lateness:\t%lu\nMaximum lateness:\t%u\n",
+        deadline_misses, total_lateness, maximum_lateness);
+  }
+  return length;
+}
+
+/*
+ * Validates an output file against the schedule it was produced from.
+ * parameters:
+ *   filename - the output file to validate
+ *   schedule - the schedule the output was produced from (whose progress is updated)
+ *   problem - where to write a description of the problem if the output is invalid
+ *   size - the size of problem
+ * returns:
+ *   TRUE if the output is valid, FALSE otherwise
+ */
+bool validate_output(const char *filename, validated_schedule *schedule, char *problem, size_t size) {
+  for (unsigned int i = 0; i < schedule->num_processes; i++) {
+    schedule->processes[i].processed_time = 0;
+  }
+
+  mapped_file file;
+  if (!map_file(filename, &file)) {
+    snprintf(problem, size, "unable to read output");
+    return FALSE;
+  }
+  const char *header = "Time\tPID\n";
+  if (file.end[-1] != '\n' || file.length < strlen(header) || memcmp(file.start, header, strlen(header)) != 0) {
+    snprintf(problem, size, "output does not start with the time step header (or is incomplete)");
+    unmap_file(&file);
+    return FALSE;
+  }
+
+  // Check each time step (lines of the form "TIME:\tPID" or "TIME:\t" when no process runs)
+  const char *p = file.start + strlen(header);
+  unsigned int num_remaining = schedule->num_processes;
+  unsigned long time = 0;
+  bool valid = TRUE;
+  while (valid && p < file.end && (unsigned char) *p - '0' < 10) {
+    unsigned long line_time = read_number(&p);
+    if (line_time != time || p[0] != ':' || p[1] != '\t') {
+      snprintf(problem, size, "time step %lu is missing or malformed", time);
+      valid = FALSE;
+      break;
+    }
+    p += 2;
+    unsigned long pid = read_number(&p);
+    if (*p++ != '\n') {
+      snprintf(problem, size, "time step %lu is malformed", time);
+      valid = FALSE;
+    } else if (pid > 0) {
+      unsigned int index = pid <= MAX_PID ? pid_indexes[pid] : 0;
+      if (index == 0) {
+        snprintf(problem, size, "time step %lu runs PID %lu, which is not in the schedule", time, pid);
+        valid = FALSE;
+        break;
+      }
+      validated_process *process = &schedule->processes[index - 1];
+      if (time < process->arrival_time) {
+        snprintf(problem, size, "time step %lu runs PID %lu before it arrives at %u", time, pid, process->arrival_time);
+        valid = FALSE;
+      } else if (process->processed_time == process->processing_time) {
+        snprintf(problem, size, "time step %lu runs PID %lu beyond its processing time of %u", time, pid,
+            process->processing_time);
+        valid = FALSE;
+      } else if (++process->processed_time == process->processing_time) {
+        process->end_time = time;
+        num_remaining--;
+      }
+    }
+    time++;
+  }
+
+  // Check every process completed, and the statistics are those of the time steps
+  if (valid && num_remaining > 0) {
+    for (unsigned int i = 0; i < schedule->num_processes; i++) {
+      if (schedule->processes[i].processed_time < schedule->processes[i].processing_time) {
+        snprintf(problem, size, "PID %u never completes (%u of its %u time units run)", schedule->processes[i].pid,
+            schedule->processes[i].processed_time, schedule->processes[i].processing_time);
+        break;
+      }
+    }
+    valid = FALSE;
+  }
+  if (valid) {
+    char statistics[MAX_STATISTICS_LENGTH];
+    size_t length = format_statistics(schedule, statistics, sizeof(statistics));
+    if ((size_t) (file.end - p) != length || memcmp(p, statistics, length) != 0) {
+      // Find the first line that differs
+      size_t line_start = 0;
+      for (size_t i = 0; i < length && p + i < file.end && p[i] == statistics[i]; i++) {
+        if (statistics[i] == '\n') {
+          line_start = i + 1;
+        }
+      }
+      const char *expected = statistics + line_start;
+      const char *found = p + line_start;
+      const char *expected_end = memchr(expected, '\n', length - line_start);
+      const char *found_end = memchr(found, '\n', file.end - found);
+      snprintf(problem, size, "statistics do not match the time steps (expected \"%.*s\", found \"%.*s\")",
+          expected_end ? (int) (expected_end - expected) : 0, expected, found_end ? (int) (found_end - found) : 0, found);
+      valid = FALSE;
+    }
+  }
+  unmap_file(&file);
+  return valid;
+}
+
+/*
+ * Determines whether the given path is a directory.
+ * parameters:
+ *   path - the path to check
+ * returns:
+ *   TRUE if the path is a directory, FALSE otherwise
+ */
+bool is_directory(const char *path) {
+  struct stat status;
+  return stat(path, &status) == 0 && S_ISDIR(status.st_mode);
+}
+
+/* The totals of the outputs validated */
+typedef struct validation_totals {
+  unsigned long valid;
+  unsigned long invalid;
+} validation_totals;
+
+/*
+ * Validates the given output file (or every file in the given directory, recursively), printing out the result.
+ * parameters:
+ *   output - the output file or directory to validate
+ *   schedules - the schedule the output was produced from, or a directory containing it (with the same name)
+ *   schedule - the last schedule read in (which is re-used if the output is from the same schedule)
+ *   schedule_filename - the file the last schedule was read in from (updated when a schedule is read in)
+ *   quiet - whether to only print out the results of invalid outputs
+ *   totals - the totals to add the results to
+ */
+void validate_path(const char *output, const char *schedules, validated_schedule *schedule, char *schedule_filename,
+    bool quiet, validation_totals *totals) {
+  if (is_directory(output)) {
+    struct dirent **entries;
+    int num_entries = scandir(output, &entries, NULL, alphasort);
+    for (int i = 0; i < num_entries; i++) {
+      if (entries[i]->d_name[0] != '.') {
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", output, entries[i]->d_name);
+        validate_path(path, schedules, schedule, schedule_filename, quiet, totals);
+      }
+      free(entries[i]);
+    }
+    if (num_entries >= 0) {
+      free(entries);
+    }
+    return;
+  }
+
+  // Find the schedule (only reading it in if it isn't the last one read in)
+  char filename[PATH_MAX];
+  if (is_directory(schedules)) {
+    const char *name = strrchr(output, '/');
+    snprintf(filename, sizeof(filename), "%s/%s", schedules, name ? name + 1 : output);
+  } else {
+    snprintf(filename, sizeof(filename), "%s", schedules);
+  }
+  char problem[256 + MAX_STATISTICS_LENGTH];
+  const char *error = NULL;
+  if (strcmp(filename, schedule_filename) != 0) {
+    error = read_schedule(filename, schedule);
+    strcpy(schedule_filename, error ? "" : filename);
+  }
+
+  bool valid = !error && validate_output(output, schedule, problem, sizeof(problem));
+  if (valid) {
+    totals->valid++;
+  } else {
+    totals->invalid++;
+  }
+  if (!valid || !quiet) {
+    printf("%s: %s\n", output, valid ? "valid" : error ? error : problem);
+  }
+}
+
+/*
+ * Prints out usage information for the program.
+ * parameters:
+ *   cmd - the command used to start the program
+ *   error - the error message that should be displayed (ignored if NULL)
+ */
+void usage(char *cmd, char *error) {
+  if (error) {
+    fprintf(stderr, "Error: %s\n\n", error);
+  }
+
+  fprintf(stderr, "Usage: %s [-q] SCHEDULES OUTPUT...\n", cmd);
+  fprintf(stderr, "Where:\n");
+  fprintf(stderr, "\t-q\t\tspecifies that only invalid outputs should be printed out\n");
+  fprintf(stderr, "\tSCHEDULES\tis the schedule the outputs were produced from, or a directory of schedules (where\n");
+  fprintf(stderr, "\t\t\teach output was produced from the schedule with the same name)\n");
+  fprintf(stderr, "\tOUTPUT\t\tis an output file of the simulator, or a directory of them (searched recursively)\n");
+}
+
+/*
+ *  Program entry point.
+ *  Validates each output given, printing out whether it is valid (or why it isn't), then the totals.
+ *  Exits with status 1 if any output is invalid.
+ */
+int main(int argc, char *argv[]) {
+  // Check arguments
+  bool quiet = FALSE;
+  int opt;
+  while ((opt = getopt(argc, argv, "q")) != -1) {
+    switch (opt) {
+      case 'q':
+        quiet = TRUE;
+        break;
+      default:
+        usage(argv[0], "Invalid command line arguments");
+        return -1;
+    }
+  }
+  if (argc - optind < 2) {
+    usage(argv[0], "Invalid command line arguments");
+    return -1;
+  }
+
+  validated_schedule schedule = {NULL, 0, FALSE};
+  char schedule_filename[PATH_MAX] = "";
+  validation_totals totals = {0, 0};
+  for (int i = optind + 1; i < argc; i++) {
+    validate_path(argv[i], argv[optind], &schedule, schedule_filename, quiet, &totals);
+  }
+  free(schedule.processes);
+
+  fprintf(stderr, "%lu valid, %lu invalid\n", totals.valid, totals.invalid);
+  return totals.invalid > 0;
+}
@@ -13,6 +13,16 @@ extern void load_idt();
 // The size of the interrupt descriptor table
 #define IDT_SIZE 256
 
+// Where the 32KB of video memory for text mode begins
+#define VIDEO_MEMORY 0xb8000
+// The size of the screen (in characters)
+#define SCREEN_WIDTH 80
+#define SCREEN_HEIGHT 25
+// The number of whole lines that fit in video memory (each character is 2 bytes)
+#define VIDEO_LINES (0x8000 / (SCREEN_WIDTH * 2))
+// A pair of blank characters (a space in light grey on black), for clearing with 32-bit stores
+#define BLANK_PAIR 0x07200720
+
 /* Specify a type to convert an address into a callable module */
 typedef void callable_module(void);
 
@@ -58,9 +68,23 @@ struct idt_entry {
 /* The interrupt descriptor table*/
 struct idt_entry IDT[IDT_SIZE];
 
-/* The current position of the cursor */
+/* The current position of the cursor (relative to the top left of the screen) */
 unsigned int cursor_position = 0;
 
+/* The position in video memory that is shown at the top left of the screen */
+unsigned int screen_start = 0;
+
+/*
+ * A copy of video memory in RAM, which the console writes to instead (as writing to video memory is slow).
+ * The lines that have changed since it was last copied to video memory are marked in dirty_lines.
+ */
+unsigned int shadow_memory[0x8000 / 4];
+unsigned int dirty_lines[(VIDEO_LINES + 31) / 32];
+
+/* The start address and cursor position the video hardware was last set to (in video memory) */
+unsigned int hardware_start = 0xFFFFFFFF;
+unsigned int hardware_cursor = 0xFFFFFFFF;
+
 /* Setup a descriptor in the Global Descriptor Table
  * (this takes care of converting the limit, access rights, and granularity to those required by the table entries)
 */
@@ -165,65 +189,145 @@ void enable_keyboard(void) {
     out_port(0x21, 0xFD); // 11111101 enables only IRQ1 (keyboard)
 }
 
-/* Sets where the cursor is currently pointing */
+/* Sets where the cursor is currently pointing (the hardware's cursor is moved when the screen is next flushed) */
 void set_cursor(unsigned int address) {
-  char high = (address >> 8) & 0xFF;  // Get the high bits of the address
-  char low = address & 0xFF;  // Get the low bits of the address
-  out_port(0x3D4, 14);  // 14 specifies we're sending the high bits
-  out_port(0x3D5, high);  // send the high bits
-  out_port(0x3D4, 15);  // 15 specifies we're sending the low bits
-  out_port(0x3D5, low);  // send the low bits
   cursor_position = address;
 }
 
-/* Writes the given character to the given address on the screen with the given colours */
+/* Sets the position in video memory that is shown at the top left of the screen (when the screen is next flushed) */
+void set_screen_start(unsigned int address) {
+  screen_start = address;
+}
+
+/* Marks the given number of lines of video memory as changed, starting at the given line */
+void mark_lines(unsigned int line, unsigned int count) {
+    for (unsigned int i = line; i < line + count; i++) {
+        dirty_lines[i / 32] |= 1u << (i % 32);
+    }
+}
+
+/*
+ * Copies the lines that have changed to video memory (two characters at a time), then updates the screen's start
+ * address and the cursor if they have moved (each takes four slow port writes).
+ */
+void flush_screen() {
+    unsigned int *vidptr = (unsigned int*)VIDEO_MEMORY;
+    for (unsigned int i = 0; i < (VIDEO_LINES + 31) / 32; i++) {
+        unsigned int dirty = dirty_lines[i];
+        dirty_lines[i] = 0;
+        for (unsigned int line = i * 32; dirty != 0; line++, dirty >>= 1) {
+            if (dirty & 1) {
+                unsigned int first = line * SCREEN_WIDTH / 2;
+                for (unsigned int j = first; j < first + SCREEN_WIDTH / 2; j++) {
+                    vidptr[j] = shadow_memory[j];
+                }
+            }
+        }
+    }
+
+    if (screen_start != hardware_start) {
+        out_port(0x3D4, 12);  // 12 specifies we're sending the high bits of the start address
+        out_port(0x3D5, (screen_start >> 8) & 0xFF);  // send the high bits
+        out_port(0x3D4, 13);  // 13 specifies we're sending the low bits
+        out_port(0x3D5, screen_start & 0xFF);  // send the low bits
+        hardware_start = screen_start;
+    }
+
+    // The cursor's location is in video memory, so it is offset by where the screen starts
+    unsigned int cursor = screen_start + cursor_position;
+    if (cursor != hardware_cursor) {
+        out_port(0x3D4, 14);  // 14 specifies we're sending the high bits
+        out_port(0x3D5, (cursor >> 8) & 0xFF);  // send the high bits
+        out_port(0x3D4, 15);  // 15 specifies we're sending the low bits
+        out_port(0x3D5, cursor & 0xFF);  // send the low bits
+        hardware_cursor = cursor;
+    }
+}
+
+/* Blanks the given number of lines of video memory, starting at the given line (two characters at a time) */
+void clear_lines(unsigned int line, unsigned int count) {
+    unsigned int *vidptr = shadow_memory + line * SCREEN_WIDTH / 2;
+    for (unsigned int i = 0; i < count * SCREEN_WIDTH / 2; i++) {
+        vidptr[i] = BLANK_PAIR;
+    }
+    mark_lines(line, count);
+}
+
+/*
+ * Scrolls the screen up a line.
+ * Rather than copying the whole screen, this moves where the screen starts down a line in video memory (so only the new
+ * line has to be cleared). Once the screen reaches the end of video memory, it is copied back to the start.
+ */
+void scroll_screen() {
+    unsigned int next_line = (screen_start / SCREEN_WIDTH) + SCREEN_HEIGHT;
+    if (next_line < VIDEO_LINES) {
+        clear_lines(next_line, 1);
+        set_screen_start(screen_start + SCREEN_WIDTH);
+    } else {
+        // Copy all but the top line to the start of video memory (two characters at a time)
+        unsigned int *line = shadow_memory + (screen_start + SCREEN_WIDTH) / 2;
+        for (int i = 0; i < SCREEN_WIDTH * (SCREEN_HEIGHT - 1) / 2; i++) {
+            shadow_memory[i] = line[i];
+        }
+        mark_lines(0, SCREEN_HEIGHT - 1);
+        clear_lines(SCREEN_HEIGHT - 1, 1);
+        set_screen_start(0);
+    }
+}
+
+/*
+ * Writes the given character to the given address on the screen with the given colours
+ * (the address must be on the screen, and the character is shown when the screen is next flushed)
+ */
 void write_char(unsigned int address, char c, unsigned char foreground, unsigned char background) {
-    char *vidptr = (char*)0xb8000; // Where video memory begins
     unsigned char colour = ((background & 0x0F) << 4) | (foreground & 0x0F);
-    if (address >= 0 && address <= 80 * 25) {
-      vidptr[address * 2] = c;
-      vidptr[address * 2 + 1] = colour;
+    unsigned short *shadow = (unsigned short*)shadow_memory + screen_start; // Where the screen begins in the copy
+    shadow[address] = (colour << 8) | (unsigned char) c;
+    mark_lines((screen_start + address) / SCREEN_WIDTH, 1);
+}
+
+/* Writes a character in light grey at the given address, scrolling first if it is past the end of the screen */
+unsigned int write_next_char(unsigned int address, char c) {
+    if (address >= SCREEN_WIDTH * SCREEN_HEIGHT) {
+        scroll_screen();
+        address -= SCREEN_WIDTH;
     }
+    write_char(address, c, 7, 0);
+    return address + 1;
 }
 
-/* Writes the given number of characters from the given message to the screen at the current cursor position */
+/*
+ * Writes the given number of characters from the given message to the screen at the current cursor position
+ * (the message is written to the copy of video memory, which is flushed to the screen once at the end)
+ */
 void write(const char *msg, int msg_len) {
     unsigned int current_address = cursor_position;
     for (int i = 0; i < msg_len; i++) {
         if (msg[i] == '\n') {
             // Handle new line characters
             do {
-                write_char(current_address, ' ', 7, 0);
-                current_address++;
+                current_address = write_next_char(current_address, ' ');
             } while (current_address % 80 != 0);
         } else if (msg[i] == '\t') {
             // Handle tab characters
             for (int j = 0; j < 8; j++) {
-              write_char(current_address, ' ', 7, 0);
-              current_address++;
+              current_address = write_next_char(current_address, ' ');
             }
         // TODO: You may wish to handle other characters here too
         } else {
             // Handle all other characters
-            write_char(current_address, msg[i], 7, 0);
-            current_address++;
+            current_address = write_next_char(current_address, msg[i]);
         }
 
         // Scroll the screen (if necessary)
-        while (current_address >= 80 * 25) {
-            char *vidptr = (char*)0xb8000; // Where video memory begins
-            for (int j = 0; j < 80 * 24 * 2; j++) {
-                vidptr[j] = vidptr[j + 80 * 2];
-            }
-            for (int j = 0; j < 80 * 2; j+=2) {
-                vidptr[80*24*2 + j] = ' ';
-                vidptr[80 * 24 * 2 + j + 1] = 0x7;
-            }
-            current_address -= 80;
+        while (current_address >= SCREEN_WIDTH * SCREEN_HEIGHT) {
+            scroll_screen();
+            current_address -= SCREEN_WIDTH;
         }
     }
-    // Update cursor position
+    // Update cursor position, and show the changes
     set_cursor(current_address);
+    flush_screen();
 }
 
 /* Outputs the given C-string to the current cursor position */
@@ -235,13 +339,12 @@ void write_string(const char *msg) {
     write(msg, count);
 }
 
-/* Clears the entire screen */
+/* Clears the entire screen (moving it back to the start of video memory) */
 void clear_screen() {
+    set_screen_start(0);
+    clear_lines(0, SCREEN_HEIGHT);
     set_cursor(0);
-    for (int i = 0; i < 25; i++) {
-        write_string("\n");
-    }
-    set_cursor(0);
+    flush_screen();
 }
 
 /* Handles keyboard presses by outputting a character to the screen */